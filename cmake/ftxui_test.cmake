@@ -13,9 +13,14 @@ FetchContent_MakeAvailable(googletest)
 add_executable(tests
   src/ftxui/component/component_test.cpp
   src/ftxui/component/container_test.cpp
+  src/ftxui/component/event_coalescing_test.cpp
+  src/ftxui/component/event_test.cpp
+  src/ftxui/component/frame_writer_test.cpp
   src/ftxui/component/input_test.cpp
+  src/ftxui/component/keymap_test.cpp
   src/ftxui/component/radiobox_test.cpp
   src/ftxui/component/receiver_test.cpp
+  src/ftxui/component/scheduler_test.cpp
   src/ftxui/component/screen_interactive_test.cpp
   src/ftxui/component/terminal_input_parser_test.cpp
   src/ftxui/component/toggle_test.cpp
@@ -25,6 +30,8 @@ add_executable(tests
   src/ftxui/dom/hbox_test.cpp
   src/ftxui/dom/text_test.cpp
   src/ftxui/dom/vbox_test.cpp
+  src/ftxui/screen/glyph_test.cpp
+  src/ftxui/screen/screen_test.cpp
   src/ftxui/screen/string_test.cpp
 )
 
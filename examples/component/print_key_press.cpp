@@ -12,7 +12,7 @@
 #include "ftxui/component/captured_mouse.hpp"  // for ftxui
 #include "ftxui/component/component.hpp"       // for CatchEvent, Renderer
 #include "ftxui/component/event.hpp"           // for Event
-#include "ftxui/component/mouse.hpp"  // for Mouse, Mouse::Left, Mouse::Middle, Mouse::None, Mouse::Pressed, Mouse::Released, Mouse::Right, Mouse::WheelDown, Mouse::WheelUp
+#include "ftxui/component/mouse.hpp"  // for Mouse, Mouse::Left, Mouse::Middle, Mouse::Moved, Mouse::None, Mouse::Pressed, Mouse::Released, Mouse::Right, Mouse::WheelDown, Mouse::WheelUp
 #include "ftxui/component/screen_interactive.hpp"  // for ScreenInteractive
 #include "ftxui/dom/elements.hpp"  // for text, vbox, window, Element, Elements
 
@@ -55,6 +55,9 @@ std::string Stringify(Event event) {
       case Mouse::Released:
         out += "_released";
         break;
+      case Mouse::Moved:
+        out += "_moved";
+        break;
     }
     if (event.mouse().control)
       out += "_control";
@@ -7,7 +7,7 @@
 #include <vector>      // for vector
 
 #include "ftxui/component/component_base.hpp"     // for Component, Components
-#include "ftxui/component/component_options.hpp"  // for ButtonOption, CheckboxOption, InputOption, MenuOption, RadioboxOption, ToggleOption
+#include "ftxui/component/component_options.hpp"  // for ButtonOption, CheckboxOption, InputOption, KeyBinding, KeymapOption, MenuOption, RadioboxOption, ToggleOption
 #include "ftxui/dom/elements.hpp"                 // for Element
 #include "ftxui/util/ref.hpp"  // for Ref, ConstStringRef, ConstStringListRef, StringRef
 
@@ -16,6 +16,7 @@ struct ButtonOption;
 struct CheckboxOption;
 struct Event;
 struct InputOption;
+struct KeymapOption;
 struct MenuOption;
 struct RadioboxOption;
 struct ToggleOption;
@@ -55,7 +56,10 @@ Component ResizableSplitBottom(Component main, Component back, int* main_size);
 Component Renderer(Component child, std::function<Element()>);
 Component Renderer(std::function<Element()>);
 Component Renderer(std::function<Element(bool /* focused */)>);
-Component CatchEvent(Component child, std::function<bool(Event)>);
+Component CatchEvent(Component child, std::function<bool(const Event&)>);
+Component Keymap(Component child,
+                 std::vector<KeyBinding> bindings,
+                 Ref<KeymapOption> option = {});
 Component Maybe(Component, bool* show);
 
 namespace Container {
@@ -1,8 +1,9 @@
 #ifndef FTXUI_COMPONENT_BASE_HPP
 #define FTXUI_COMPONENT_BASE_HPP
 
-#include <memory>  // for unique_ptr
-#include <vector>  // for vector
+#include <stddef.h>  // for size_t
+#include <memory>    // for unique_ptr
+#include <vector>    // for vector
 
 #include "ftxui/component/captured_mouse.hpp"  // for CaptureMouse
 #include "ftxui/dom/elements.hpp"              // for Element
@@ -40,7 +41,7 @@ class ComponentBase {
   // By default, reduce on children with a lazy OR.
   //
   // Returns whether the event was handled or not.
-  virtual bool OnEvent(Event);
+  virtual bool OnEvent(const Event&);
 
   // Focus management ----------------------------------------------------------
   //
@@ -61,6 +62,26 @@ class ComponentBase {
   // Whether all the ancestors are active.
   bool Focused() const;
 
+  // Active() and Focused() are cached while a FocusCache exists on the calling
+  // thread, like while ScreenInteractive renders the components. Otherwise,
+  // they reflect the current state.
+  class FocusCache {
+   public:
+    FocusCache();
+    ~FocusCache();
+    FocusCache(const FocusCache&) = delete;
+    FocusCache& operator=(const FocusCache&) = delete;
+  };
+
+  // The cache is cleared by SetActiveChild(), TakeFocus(), Add() and Detach().
+  // A component whose ActiveChild() changes otherwise must call
+  // InvalidateFocus().
+  static void InvalidateFocus();
+
+  // Called by ScreenInteractive when the component gains or loses the focus,
+  // once per frame at most.
+  virtual void OnFocusChange(bool focused);
+
   // Make the |child| to be the "active" one.
   virtual void SetActiveChild(ComponentBase* child);
   void SetActiveChild(Component child);
@@ -74,7 +95,15 @@ class ComponentBase {
   Components children_;
 
  private:
+  ComponentBase* ActiveChildCached() const;
+
   ComponentBase* parent_ = nullptr;
+
+  // The focus state, computed once per focus generation.
+  mutable size_t active_child_generation_ = 0;
+  mutable ComponentBase* active_child_ = nullptr;
+  mutable size_t focused_generation_ = 0;
+  mutable bool focused_ = false;
 };
 
 }  // namespace ftxui
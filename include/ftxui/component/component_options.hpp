@@ -1,8 +1,11 @@
 #ifndef FTXUI_COMPONENT_COMPONENT_OPTIONS_HPP
 #define FTXUI_COMPONENT_COMPONENT_OPTIONS_HPP
 
+#include <chrono>  // for milliseconds
+#include <ftxui/component/event.hpp>
 #include <ftxui/dom/elements.hpp>
 #include <ftxui/util/ref.hpp>
+#include <vector>  // for vector
 
 namespace ftxui {
 
@@ -105,6 +108,22 @@ struct ToggleOption {
   Ref<int> focused_entry = 0;
 };
 
+/// @brief A sequence of keys, and the action it triggers. See Keymap().
+/// @ingroup component
+struct KeyBinding {
+  /// The keys, pressed one after the other. For instance `g g`.
+  std::vector<Event> keys;
+  /// Called when the keys have been pressed.
+  std::function<void()> action;
+};
+
+/// @brief Option for the Keymap component.
+/// @ingroup component
+struct KeymapOption {
+  /// The maximum delay between two keys of a sequence.
+  std::chrono::milliseconds timeout = std::chrono::milliseconds(1000);
+};
+
 }  // namespace ftxui
 
 #endif /* end of include guard: FTXUI_COMPONENT_COMPONENT_OPTIONS_HPP */
@@ -2,6 +2,8 @@
 #define FTXUI_COMPONENT_EVENT_HPP
 
 #include <ftxui/component/mouse.hpp>  // for Mouse
+#include <stdint.h>                   // for uint8_t
+#include <cstring>                    // for memcmp, size_t
 #include <string>                     // for string, operator==
 #include <vector>
 
@@ -20,6 +22,10 @@ class ComponentBase;
 ///   ./example/util/print_key_press
 ///  For instance, CTLR+A maps to Event::Special({1});
 ///
+/// The known keys are stored as a key code and modifiers, and the characters
+/// as inline UTF-8, so that comparing two events is cheap. Only the unknown
+/// sequences keep their input as a string.
+///
 /// Useful documentation about xterm specification:
 /// https://invisible-island.net/xterm/ctlseqs/ctlseqs.html
 struct Event {
@@ -30,6 +36,7 @@ struct Event {
   static Event Special(std::string);
   static Event Mouse(std::string, Mouse mouse);
   static Event CursorReporting(std::string, int x, int y);
+  static Event Paste(std::string text);
 
   // --- Arrow ---
   static const Event ArrowLeft;
@@ -55,37 +62,115 @@ struct Event {
   // --- Custom ---
   static Event Custom;
 
+  // --- Key section ---
+  // The keys identified by FTXUI. The other ones are Unknown, and identified
+  // by their input.
+  enum class Key : uint8_t {
+    Unknown,
+    Character,
+    ArrowLeft,
+    ArrowRight,
+    ArrowUp,
+    ArrowDown,
+    Backspace,
+    Delete,
+    Return,
+    Escape,
+    Tab,
+    TabReverse,
+    F1,
+    F2,
+    F3,
+    F4,
+    F5,
+    F6,
+    F7,
+    F8,
+    F9,
+    F10,
+    F11,
+    F12,
+    Home,
+    End,
+    PageUp,
+    PageDown,
+    Custom,
+  };
+
   //--- Method section ---------------------------------------------------------
   bool is_character() const { return type_ == Type::Character; }
-  std::string character() const { return input_; }
+  std::string character() const { return input(); }
+
+  Key key() const { return key_; }
+  // The modifiers held with a key, as reported by the terminal. For instance
+  // CTRL+ArrowLeft.
+  bool shift() const { return modifiers_ & kShift; }
+  bool alt() const { return modifiers_ & kAlt; }
+  bool control() const { return modifiers_ & kControl; }
 
   bool is_mouse() const { return type_ == Type::Mouse; }
   struct Mouse& mouse() {
     return mouse_;
   }
+  const struct Mouse& mouse() const { return mouse_; }
 
   bool is_cursor_reporting() const { return type_ == Type::CursorReporting; }
   int cursor_x() const { return cursor_.x; }
   int cursor_y() const { return cursor_.y; }
 
-  const std::string& input() const { return input_; }
-
-  bool operator==(const Event& other) const { return input_ == other.input_; }
+  // Text pasted into the terminal, received at once. See bracketed paste.
+  bool is_paste() const { return type_ == Type::Paste; }
+  std::string paste() const;
+
+  // The sequence received from the terminal. Known keys are given their
+  // canonical sequence.
+  std::string input() const;
+
+  bool operator==(const Event& other) const {
+    if (key_ != other.key_ || modifiers_ != other.modifiers_)
+      return false;
+    if (size_ != 0 || other.size_ != 0) {
+      return size_ == other.size_ &&
+             std::memcmp(utf8_, other.utf8_, sizeof(utf8_)) == 0;
+    }
+    if (key_ == Key::Unknown || key_ == Key::Character)
+      return input_ == other.input_;
+    return true;
+  }
   bool operator!=(const Event& other) const { return !operator==(other); }
 
+  // For use as the key of an unordered container.
+  struct Hash {
+    size_t operator()(const Event& event) const;
+  };
+
   //--- State section ----------------------------------------------------------
   ScreenInteractive* screen_ = nullptr;
 
  private:
   friend ComponentBase;
   friend ScreenInteractive;
-  enum class Type {
+  enum class Type : uint8_t {
     Unknown,
     Character,
     Mouse,
     CursorReporting,
+    Paste,
   };
   Type type_ = Type::Unknown;
+  Key key_ = Key::Unknown;
+
+  enum Modifier : uint8_t {
+    kShift = 1,
+    kAlt = 2,
+    kControl = 4,
+  };
+  uint8_t modifiers_ = 0;
+
+  // The UTF-8 of a character, when it fits. |size_| is zero otherwise, and
+  // the character is stored in |input_|.
+  uint8_t size_ = 0;
+  char utf8_[8] = {};
 
   struct Cursor {
     int x;
@@ -96,6 +181,8 @@ struct Event {
     struct Mouse mouse_;
     struct Cursor cursor_;
   };
+  // The input of the unknown sequences, mouse events, cursor reports and
+  // pastes.
   std::string input_;
 };
 
@@ -18,6 +18,7 @@ struct Mouse {
   enum Motion {
     Released = 0,
     Pressed = 1,
+    Moved = 2,  // The mouse moved, with |button| held or None.
   };
 
   // Button
@@ -1,15 +1,21 @@
 #ifndef FTXUI_COMPONENT_RECEIVER_HPP_
 #define FTXUI_COMPONENT_RECEIVER_HPP_
 
+#include <stddef.h>            // for size_t
+#include <stdint.h>            // for intptr_t
 #include <algorithm>           // for copy
-#include <atomic>              // for atomic, __atomic_base
+#include <atomic>              // for atomic, atomic_thread_fence
+#include <chrono>              // for steady_clock
 #include <condition_variable>  // for condition_variable
+#include <deque>               // for deque
 #include <functional>
 #include <iostream>
-#include <memory>   // for unique_ptr, make_unique
-#include <mutex>    // for mutex, unique_lock
-#include <queue>    // for queue
-#include <utility>  // for move
+#include <memory>       // for unique_ptr, make_unique
+#include <mutex>        // for mutex, unique_lock
+#include <new>          // for operator new
+#include <type_traits>  // for aligned_storage
+#include <utility>      // for move
+#include <vector>       // for vector
 
 namespace ftxui {
 
@@ -36,6 +42,24 @@ namespace ftxui {
 //   print(c)
 //
 // Receiver::Receive() returns true when there are no more senders.
+//
+// Capacity:
+// ---------
+// The receiver is a bounded lock-free queue. The OverflowPolicy decides what
+// Send() does when it is full. By default, the items exceeding the capacity
+// are kept in a list, so Send() never blocks:
+//
+// auto receiver = MakeReceiver<Event>(256, OverflowPolicy::DropOldest);
+//
+// Priority:
+// ---------
+// A receiver can have several lanes, each one being a separate queue. Items
+// from the lane 0 are received first, then from the lane 1, etc.
+//
+// auto receiver = MakeReceiver<Event>(256, OverflowPolicy::Grow, 2);
+// receiver->SetOverflowPolicy(0, OverflowPolicy::Block);
+// auto urgent = receiver->MakeSender(0);
+// auto background = receiver->MakeSender(1);
 
 // clang-format off
 template<class T> class SenderImpl;
@@ -43,79 +67,393 @@ template<class T> class ReceiverImpl;
 
 template<class T> using Sender = std::unique_ptr<SenderImpl<T>>;
 template<class T> using Receiver = std::unique_ptr<ReceiverImpl<T>>;
-template<class T> Receiver<T> MakeReceiver();
 // clang-format on
 
+enum class OverflowPolicy {
+  Grow,        // Keep the item aside, until the queue has room.
+  Block,       // Wait for the receiver to make room. The receiving thread
+               // must not send, or it waits for itself.
+  DropOldest,  // Discard the oldest item.
+  DropNewest,  // Discard the item being sent.
+};
+
+constexpr size_t kDefaultReceiverCapacity = 1024;
+
+template <class T>
+Receiver<T> MakeReceiver(size_t capacity = kDefaultReceiverCapacity,
+                         OverflowPolicy policy = OverflowPolicy::Grow,
+                         size_t lanes = 1);
+
 // ---- Implementation part ----
 
 template <class T>
 class SenderImpl {
  public:
-  void Send(T t) { receiver_->Receive(std::move(t)); }
+  void Send(T t) { receiver_->Receive(lane_, std::move(t)); }
+  // Send all the |items|, then clear them. The receiver is woken up once.
+  void SendAll(std::vector<T>* items) { receiver_->Receive(lane_, items); }
   ~SenderImpl() { receiver_->ReleaseSender(); }
 
-  Sender<T> Clone() { return receiver_->MakeSender(); }
+  Sender<T> Clone() { return receiver_->MakeSender(lane_); }
 
  private:
   friend class ReceiverImpl<T>;
-  SenderImpl(ReceiverImpl<T>* consumer) : receiver_(consumer) {}
+  SenderImpl(ReceiverImpl<T>* consumer, size_t lane)
+      : receiver_(consumer), lane_(lane) {}
   ReceiverImpl<T>* receiver_;
+  size_t lane_;
+};
+
+// A bounded multi-producer queue, based on Dmitry Vyukov's algorithm. Every
+// cell holds a sequence number telling whether it is ready to be written or
+// read at a given position.
+template <class T>
+class RingBuffer {
+ public:
+  RingBuffer(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity)
+      size *= 2;
+    mask_ = size - 1;
+    cells_ = std::make_unique<Cell[]>(size);
+    for (size_t i = 0; i < size; ++i)
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  ~RingBuffer() {
+    T t;
+    while (TryPop(&t)) {
+    }
+  }
+
+  bool TryPush(T& t) {
+    size_t position = push_position_.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+      cell = &cells_[position & mask_];
+      const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t difference = intptr_t(sequence) - intptr_t(position);
+      if (difference == 0) {
+        if (push_position_.compare_exchange_weak(position, position + 1,
+                                                 std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;  // Full.
+      } else {
+        position = push_position_.load(std::memory_order_relaxed);
+      }
+    }
+    new (&cell->storage) T(std::move(t));
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool TryPop(T* t) {
+    size_t position = pop_position_.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+      cell = &cells_[position & mask_];
+      const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t difference = intptr_t(sequence) - intptr_t(position + 1);
+      if (difference == 0) {
+        if (pop_position_.compare_exchange_weak(position, position + 1,
+                                                std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;  // Empty.
+      } else {
+        position = pop_position_.load(std::memory_order_relaxed);
+      }
+    }
+    T* item = reinterpret_cast<T*>(&cell->storage);
+    *t = std::move(*item);
+    item->~T();
+    cell->sequence.store(position + mask_ + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool Empty() const {
+    const size_t position = pop_position_.load(std::memory_order_relaxed);
+    const Cell& cell = cells_[position & mask_];
+    return cell.sequence.load(std::memory_order_acquire) != position + 1;
+  }
+
+  bool Full() const {
+    const size_t position = push_position_.load(std::memory_order_relaxed);
+    const Cell& cell = cells_[position & mask_];
+    return cell.sequence.load(std::memory_order_acquire) != position;
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+  };
+
+  size_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+  alignas(64) std::atomic<size_t> push_position_ = 0;
+  alignas(64) std::atomic<size_t> pop_position_ = 0;
 };
 
+// A RingBuffer, and the items that didn't fit in it with OverflowPolicy::Grow.
+// Once an item overflowed, the next ones are queued after it, until the
+// receiver took them all. This keeps the order of every sender.
+template <class T>
+class ReceiverLane {
+ public:
+  ReceiverLane(size_t capacity, OverflowPolicy policy)
+      : ring_(capacity), policy_(policy) {}
+
+  RingBuffer<T>& ring() { return ring_; }
+  OverflowPolicy policy() const { return policy_; }
+  void set_policy(OverflowPolicy policy) { policy_ = policy; }
+
+  bool TryPush(T& t) {
+    if (policy_ != OverflowPolicy::Grow)
+      return ring_.TryPush(t);
+    if (overflow_size_ == 0 && ring_.TryPush(t))
+      return true;
+    std::lock_guard<std::mutex> lock(overflow_mutex_);
+    overflow_.push_back(std::move(t));
+    overflow_size_++;
+    return true;
+  }
+
+  bool TryPop(T* t) {
+    if (ring_.TryPop(t))
+      return true;
+    if (overflow_size_ == 0)
+      return false;
+    std::lock_guard<std::mutex> lock(overflow_mutex_);
+    if (overflow_.empty())
+      return false;
+    *t = std::move(overflow_.front());
+    overflow_.pop_front();
+    overflow_size_--;
+    return true;
+  }
+
+  bool PopAll(std::vector<T>* items) {
+    bool received = false;
+    T t;
+    while (ring_.TryPop(&t)) {
+      items->push_back(std::move(t));
+      received = true;
+    }
+    if (overflow_size_ == 0)
+      return received;
+    std::lock_guard<std::mutex> lock(overflow_mutex_);
+    for (T& item : overflow_)
+      items->push_back(std::move(item));
+    received |= !overflow_.empty();
+    overflow_.clear();
+    overflow_size_ = 0;
+    return received;
+  }
+
+  bool Empty() const { return ring_.Empty() && overflow_size_ == 0; }
+
+ private:
+  RingBuffer<T> ring_;
+  OverflowPolicy policy_;
+  std::mutex overflow_mutex_;
+  std::deque<T> overflow_;
+  std::atomic<size_t> overflow_size_ = 0;
+};
+
+// The mutex and condition variables are only used to put threads to sleep,
+// when the lanes are empty or full.
 template <class T>
 class ReceiverImpl {
  public:
-  Sender<T> MakeSender() {
-    std::unique_lock<std::mutex> lock(mutex_);
+  Sender<T> MakeSender(size_t lane = 0) {
     senders_++;
-    return std::unique_ptr<SenderImpl<T>>(new SenderImpl<T>(this));
+    return std::unique_ptr<SenderImpl<T>>(new SenderImpl<T>(this, lane));
+  }
+
+  ReceiverImpl(size_t capacity, OverflowPolicy policy, size_t lanes)
+      : skipped_batches_(lanes, 0) {
+    for (size_t lane = 0; lane < lanes; ++lane)
+      lanes_.push_back(std::make_unique<ReceiverLane<T>>(capacity, policy));
   }
-  ReceiverImpl() { senders_ = 0; }
 
+  // Use |policy| for the |lane|, instead of the one given to MakeReceiver().
+  // Must be called before making its senders.
+  void SetOverflowPolicy(size_t lane, OverflowPolicy policy) {
+    lanes_[lane]->set_policy(policy);
+  }
+
+  // Wait for an item, taken from the first non empty lane. Returns false once
+  // the lanes are empty and there are no more senders.
   bool Receive(T* t) {
-    while (senders_ || !queue_.empty()) {
-      std::unique_lock<std::mutex> lock(mutex_);
-      if (queue_.empty())
-        notifier_.wait(lock);
-      if (queue_.empty())
-        continue;
-      *t = std::move(queue_.front());
-      queue_.pop();
-      return true;
+    while (true) {
+      for (auto& lane : lanes_) {
+        if (lane->TryPop(t)) {
+          NotifyProducers();
+          return true;
+        }
+      }
+      if (!WaitForItems())
+        return false;
     }
-    return false;
   }
 
-  bool HasPending() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    return !queue_.empty();
+  using TimePoint = std::chrono::steady_clock::time_point;
+
+  // Wait for items, then move the ones from the first non empty lane at the
+  // end of |items|. Returns false once the lanes are empty and there are no
+  // more senders.
+  //
+  // A lane skipped more than |starvation_limit| consecutive times while not
+  // being empty is taken too. See SetStarvationLimit().
+  bool ReceiveAll(std::vector<T>* items) {
+    return ReceiveAllUntil(items, TimePoint::max());
+  }
+
+  // Same as ReceiveAll(), but returns true without items once |deadline| is
+  // reached.
+  bool ReceiveAllUntil(std::vector<T>* items, TimePoint deadline) {
+    while (true) {
+      bool received = false;
+      for (size_t lane = 0; lane < lanes_.size(); ++lane) {
+        if (lanes_[lane]->Empty()) {
+          skipped_batches_[lane] = 0;
+          continue;
+        }
+        if (received && ++skipped_batches_[lane] <= starvation_limit_)
+          continue;
+        skipped_batches_[lane] = 0;
+        received |= lanes_[lane]->PopAll(items);
+      }
+      if (received) {
+        NotifyProducers();
+        return true;
+      }
+      if (!WaitForItems(deadline))
+        return false;
+      if (Empty() && std::chrono::steady_clock::now() >= deadline)
+        return true;
+    }
   }
 
+  // The number of consecutive ReceiveAll() a non empty lane can be skipped,
+  // because a higher priority one wasn't empty.
+  void SetStarvationLimit(int batches) { starvation_limit_ = batches; }
+
+  bool HasPending() { return !Empty(); }
+
  private:
   friend class SenderImpl<T>;
 
-  void Receive(T t) {
-    {
-      std::unique_lock<std::mutex> lock(mutex_);
-      queue_.push(std::move(t));
+  void Receive(size_t lane, T t) {
+    Push(*lanes_[lane], t);
+    NotifyConsumer();
+  }
+
+  void Receive(size_t lane, std::vector<T>* items) {
+    for (T& t : *items)
+      Push(*lanes_[lane], t);
+    items->clear();
+    NotifyConsumer();
+  }
+
+  void Push(ReceiverLane<T>& lane, T& t) {
+    while (!lane.TryPush(t)) {
+      switch (lane.policy()) {
+        case OverflowPolicy::Grow:
+          break;
+        case OverflowPolicy::Block:
+          // The items already pushed must be received to make room.
+          NotifyConsumer();
+          WaitForRoom(lane.ring());
+          break;
+        case OverflowPolicy::DropOldest: {
+          T dropped;
+          lane.ring().TryPop(&dropped);
+          break;
+        }
+        case OverflowPolicy::DropNewest:
+          return;
+      }
     }
-    notifier_.notify_one();
   }
 
   void ReleaseSender() {
     senders_--;
+    std::unique_lock<std::mutex> lock(mutex_);
     notifier_.notify_one();
   }
 
+  bool Empty() const {
+    for (auto& lane : lanes_) {
+      if (!lane->Empty())
+        return false;
+    }
+    return true;
+  }
+
+  // Sleep until the lanes might contain items, or until |deadline|. Returns
+  // false if they are empty and there are no more senders.
+  bool WaitForItems(TimePoint deadline = TimePoint::max()) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    consumer_waiting_ = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (Empty() && senders_ != 0) {
+      if (deadline == TimePoint::max())
+        notifier_.wait(lock);
+      else
+        notifier_.wait_until(lock, deadline);
+    }
+    consumer_waiting_ = false;
+    return !Empty() || senders_ != 0;
+  }
+
+  // Sleep until |ring| might have room for an item.
+  void WaitForRoom(const RingBuffer<T>& ring) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    producers_waiting_++;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ring.Full())
+      room_notifier_.wait(lock);
+    producers_waiting_--;
+  }
+
+  void NotifyConsumer() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!consumer_waiting_)
+      return;
+    std::unique_lock<std::mutex> lock(mutex_);
+    notifier_.notify_one();
+  }
+
+  void NotifyProducers() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (producers_waiting_ == 0)
+      return;
+    std::unique_lock<std::mutex> lock(mutex_);
+    room_notifier_.notify_all();
+  }
+
+  std::vector<std::unique_ptr<ReceiverLane<T>>> lanes_;
+
+  // Owned by the receiving thread:
+  std::vector<int> skipped_batches_;
+  int starvation_limit_ = 4;
+
   std::mutex mutex_;
-  std::queue<T> queue_;
   std::condition_variable notifier_;
-  std::atomic<int> senders_;
+  std::condition_variable room_notifier_;
+  std::atomic<bool> consumer_waiting_ = false;
+  std::atomic<int> producers_waiting_ = 0;
+  std::atomic<int> senders_ = 0;
 };
 
 template <class T>
-Receiver<T> MakeReceiver() {
-  return std::make_unique<ReceiverImpl<T>>();
+Receiver<T> MakeReceiver(size_t capacity, OverflowPolicy policy, size_t lanes) {
+  return std::make_unique<ReceiverImpl<T>>(capacity, policy, lanes);
 }
 
 }  // namespace ftxui
@@ -2,18 +2,24 @@
 #define FTXUI_COMPONENT_SCREEN_INTERACTIVE_HPP
 
 #include <atomic>                        // for atomic
+#include <chrono>                        // for steady_clock
 #include <ftxui/component/receiver.hpp>  // for Receiver, Sender
 #include <functional>                    // for function
 #include <memory>                        // for shared_ptr
 #include <string>                        // for string
 #include <thread>                        // for thread
+#include <vector>                        // for vector
 
 #include "ftxui/component/captured_mouse.hpp"  // for CapturedMouse
 #include "ftxui/component/event.hpp"           // for Event
+#include "ftxui/component/task.hpp"            // for Task, Closure
 #include "ftxui/screen/screen.hpp"             // for Screen
 
 namespace ftxui {
 class ComponentBase;
+class FrameWriter;
+class HitMap;
+class Scheduler;
 struct Event;
 
 using Component = std::shared_ptr<ComponentBase>;
@@ -24,13 +30,71 @@ class ScreenInteractive : public Screen {
   static ScreenInteractive Fullscreen();
   static ScreenInteractive FitComponent();
   static ScreenInteractive TerminalOutput();
+  ~ScreenInteractive();
 
   void Loop(Component);
   std::function<void()> ExitLoopClosure();
 
   void PostEvent(Event event);
+  // Run |task| on the loop thread, before the next frame. The tasks posted
+  // in a row are executed together, and drawn once.
+  void Post(Task task);
   CapturedMouse CaptureMouse();
 
+  // The terminal input is handled before the posted events. They can be
+  // skipped at most |batches| consecutive times, in favor of the input.
+  void SetStarvationLimit(int batches);
+
+  // Timers, run on the loop thread between two batches of events. These
+  // functions must be called from the loop thread, or before Loop(). From
+  // other threads, use Post().
+  using Duration = std::chrono::steady_clock::duration;
+  TimerId SetTimeout(Closure closure, Duration delay);
+  TimerId SetInterval(Closure closure, Duration period);
+  void ClearTimer(TimerId id);
+  // Run |closure| before the next frame. Animation frames are drawn at most
+  // every 16ms.
+  void RequestAnimationFrame(Closure closure);
+  // Run |closure| once no event is pending, before drawing.
+  void RequestIdleCallback(Closure closure);
+
+  // Draw at most |fps| frames per second. The events received in between are
+  // drawn together. Zero, the default, means no limit.
+  void SetMaxFrameRate(int fps);
+  // Only draw when RequestRedraw() is called, when an animation frame is
+  // requested, or when the terminal is resized. By default, a frame is drawn
+  // after handling events, posted tasks and timers.
+  void SetRedrawOnDemand(bool enabled) { redraw_on_demand_ = enabled; }
+  // Draw a new frame. This can be called from any thread.
+  void RequestRedraw();
+
+  // Send every frame as a synchronized update (DEC mode 2026), so that the
+  // terminal displays it at once. This is the default. Terminals not
+  // supporting it ignore it.
+  void SetSynchronizedUpdate(bool enabled) { synchronized_update_ = enabled; }
+
+  // Merge the redundant events received since the last frame before
+  // dispatching them: intermediate mouse motions and repeated
+  // |Event::Custom|. This is the default.
+  void SetEventCoalescing(bool enabled) { event_coalescing_ = enabled; }
+
+  // A lone ESC byte is also the start of an escape sequence. It is reported as
+  // Event::Escape once no other byte followed it during |timeout|. 50ms by
+  // default. Applies to the next Loop().
+  void SetEscapeTimeout(std::chrono::milliseconds timeout) {
+    escape_timeout_ = timeout;
+  }
+  // Ask the terminal to report keys using the kitty keyboard protocol
+  // ("disambiguate escape codes"). The ESC key is then received without
+  // waiting for the timeout. Terminals not supporting it ignore it.
+  void SetKittyKeyboardProtocol(bool enabled) {
+    kitty_keyboard_protocol_ = enabled;
+  }
+
+  // The number of bytes sent to the terminal to draw the last frame. See
+  // Screen::SetOutputMode() to reduce it.
+  size_t LastFrameBytes() const;
+
  private:
   void Install();
   void Uninstall();
@@ -40,6 +104,21 @@ class ScreenInteractive : public Screen {
   void Draw(Component component);
   void EventLoop(Component component);
 
+  // Mouse routing: the mouse events go to the component under the mouse, or
+  // capturing the mouse, through its ancestors only.
+  friend ComponentBase;
+  void DispatchMouse(const Component& component, const Event& event);
+  ComponentBase* MouseRoute(const ComponentBase* component) const;
+  CapturedMouse CaptureMouse(ComponentBase* owner);
+
+  // Dispatch the text of an Event::Paste not handled by |component| as the
+  // events it was received as without bracketed paste.
+  void DispatchPasteAsInput(const Component& component, const Event& paste);
+
+  // Notify the components gaining or losing the focus since the last call.
+  // Returns whether any was.
+  bool NotifyFocusChange(const Component& component);
+
   enum class Dimension {
     FitComponent,
     Fixed,
@@ -53,19 +132,41 @@ class ScreenInteractive : public Screen {
                     Dimension dimension,
                     bool use_alternative_screen);
 
-  Sender<Event> event_sender_;
-  Receiver<Event> event_receiver_;
+  Sender<Task> task_sender_;
+  Receiver<Task> task_receiver_;
+  bool event_coalescing_ = true;
+  std::chrono::milliseconds escape_timeout_{50};
+  bool kitty_keyboard_protocol_ = false;
 
-  std::string set_cursor_position;
-  std::string reset_cursor_position;
+  // Sends the frames to the terminal, without blocking.
+  std::unique_ptr<FrameWriter> frame_writer_;
+  std::unique_ptr<Scheduler> scheduler_;
+  Duration frame_interval_ = Duration::zero();
+  bool redraw_on_demand_ = false;
+  std::atomic<bool> redraw_requested_ = false;
+  bool synchronized_update_ = true;
 
   std::atomic<bool> quit_ = false;
   std::thread event_listener_;
 
+  // The terminal dimensions, queried again only after a resize.
+  Dimensions terminal_size_ = {0, 0};
+  std::atomic<bool> terminal_resized_ = true;
+
   int cursor_x_ = 1;
   int cursor_y_ = 1;
 
   bool mouse_captured = false;
+  ComponentBase* mouse_owner_ = nullptr;
+  // The component drawn on each cell.
+  std::unique_ptr<HitMap> hit_map_;
+  // From the root to the target of the mouse event being dispatched.
+  std::vector<ComponentBase*> mouse_path_;
+  // The component under the mouse, during the previous event.
+  std::weak_ptr<ComponentBase> mouse_target_;
+
+  // The chain of active components from the root, at the last focus check.
+  std::vector<std::weak_ptr<ComponentBase>> focus_path_;
 };
 
 }  // namespace ftxui
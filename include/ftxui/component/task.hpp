@@ -0,0 +1,26 @@
+#ifndef FTXUI_COMPONENT_TASK_HPP
+#define FTXUI_COMPONENT_TASK_HPP
+
+#include <functional>  // for function
+#include <variant>     // for variant
+
+#include "ftxui/component/event.hpp"  // for Event
+
+namespace ftxui {
+
+using Closure = std::function<void()>;
+
+// The work executed by the ScreenInteractive loop: either an Event dispatched
+// to the component tree, or a Closure run on the loop thread.
+using Task = std::variant<Event, Closure>;
+
+// Identifies a timer, to cancel it. See ScreenInteractive::SetTimeout().
+using TimerId = int;
+
+}  // namespace ftxui
+
+#endif /* end of include guard: FTXUI_COMPONENT_TASK_HPP */
+
+// Copyright 2021 Arthur Sonzogni. All rights reserved.
+// Use of this source code is governed by the MIT license that can be found in
+// the LICENSE file.
@@ -304,6 +304,7 @@ class Color {
   bool operator!=(const Color& rhs) const;
 
   std::string Print(bool is_background_color) const;
+  void Print(bool is_background_color, std::string& out) const;
 
  private:
   enum class ColorType : uint8_t {
@@ -0,0 +1,86 @@
+#ifndef FTXUI_SCREEN_GLYPH_HPP
+#define FTXUI_SCREEN_GLYPH_HPP
+
+#include <stdint.h>  // for uint32_t
+#include <iosfwd>    // for ostream
+#include <string>    // for string
+
+namespace ftxui {
+
+/// @brief A grapheme cluster, occupying one cell of the Screen.
+///
+/// A Glyph is stored as a small integer identifier and its precomputed display
+/// width. Glyphs made of a single codepoint use the codepoint as identifier.
+/// The others, like characters using combining codepoints, are interned in a
+/// global table. The table never shrinks. It holds about one million clusters,
+/// the next ones are displayed as U+FFFD.
+///
+/// It is assignable from and convertible into an UTF8 std::string.
+/// @ingroup screen
+class Glyph {
+ public:
+  Glyph() : id_(' '), width_(1) {}
+  Glyph(const std::string& value) { Set(value); }
+  Glyph(const char* value) { Set(value); }
+
+  // The glyph of a single |codepoint|, displayed using |width| cells.
+  static Glyph FromCodepoint(uint32_t codepoint, int width) {
+    Glyph glyph;
+    glyph.id_ = codepoint;
+    glyph.width_ = width;
+    return glyph;
+  }
+
+  Glyph& operator=(const std::string& value) {
+    Set(value);
+    return *this;
+  }
+  Glyph& operator=(const char* value) {
+    Set(value);
+    return *this;
+  }
+
+  // The UTF8 representation:
+  operator std::string() const;
+  void AppendTo(std::string& out) const;
+
+  // The identifier. Below kFirstClusterId, this is the codepoint.
+  static constexpr uint32_t kFirstClusterId = 0x110000;
+  uint32_t id() const { return id_; }
+
+  // The number of cells used to display the glyph.
+  int width() const { return width_; }
+
+  bool operator==(const Glyph& other) const {
+    return id_ == other.id_;
+  }
+  bool operator!=(const Glyph& other) const {
+    return id_ != other.id_;
+  }
+
+ private:
+  void Set(const std::string& value) {
+    // Quick path for ASCII:
+    if (value.size() == 1 && static_cast<unsigned char>(value[0]) >= 32 &&
+        static_cast<unsigned char>(value[0]) < 127) {
+      id_ = static_cast<unsigned char>(value[0]);
+      width_ = 1;
+      return;
+    }
+    Intern(value);
+  }
+  void Intern(const std::string& value);
+
+  uint32_t id_ : 30;
+  uint32_t width_ : 2;
+};
+
+std::ostream& operator<<(std::ostream& out, const Glyph& glyph);
+
+}  // namespace ftxui
+
+#endif /* end of include guard: FTXUI_SCREEN_GLYPH_HPP */
+
+// Copyright 2021 Arthur Sonzogni. All rights reserved.
+// Use of this source code is governed by the MIT license that can be found in
+// the LICENSE file.
@@ -1,12 +1,14 @@
 #ifndef FTXUI_SCREEN_SCREEN
 #define FTXUI_SCREEN_SCREEN
 
+#include <stdint.h>  // for uint64_t
 #include <memory>
 #include <string>  // for string, allocator, basic_string
 #include <vector>  // for vector
 
 #include "ftxui/screen/box.hpp"       // for Box
 #include "ftxui/screen/color.hpp"     // for Color, Color::Default
+#include "ftxui/screen/glyph.hpp"     // for Glyph
 #include "ftxui/screen/terminal.hpp"  // for Dimensions
 
 namespace ftxui {
@@ -16,7 +18,7 @@ namespace ftxui {
 struct Pixel {
   // The graphemes stored into the pixel. To support combining characters,
   // like: a⃦, this can potentially contains multiple codepoitns.
-  std::string character = " ";
+  Glyph character;
 
   // Colors:
   Color background_color = Color::Default;
@@ -54,19 +56,44 @@ class Screen {
   static Screen Create(Dimensions width, Dimensions height);
 
   // Node write into the screen using Screen::at.
-  std::string& at(int x, int y);
+  Glyph& at(int x, int y);
   Pixel& PixelAt(int x, int y);
 
+  // The dimx() pixels of the row |y|, stored contiguously. Unlike PixelAt(),
+  // this doesn't check the position against the stencil.
+  Pixel* Row(int y) { return pixels_.data() + y * dimx_; }
+
   // Convert the screen into a printable string in the terminal.
   std::string ToString();
+  std::string ToString(const Screen& previous);
   void Print();
 
+  // How Serialize() encodes the Screen. The defaults are fine for most
+  // terminals. The other options reduce the output size on slow links.
+  struct OutputMode {
+    // Use REP for repeated characters and ECH for blanks ending a row.
+    bool compress = false;
+    // Use the DEC special graphics character set for light box drawing
+    // characters. They take 1 byte instead of 3.
+    bool dec_special_graphics = false;
+  };
+  void SetOutputMode(OutputMode mode) { output_mode_ = mode; }
+  OutputMode output_mode() const { return output_mode_; }
+
+  // Same as ToString(), appending to a buffer the caller can reuse.
+  void Serialize(std::string& out);
+  void Serialize(const Screen& previous, std::string& out);
+
+  // Scroll the terminal to reuse the rows of |previous| shifted vertically.
+  void SerializeScroll(Screen& previous, std::string& out);
+
   // Get screen dimensions.
   int dimx() { return dimx_; }
   int dimy() { return dimy_; }
 
   // Move the terminal cursor n-lines up with n = dimy().
   std::string ResetPosition(bool clear = false);
+  void ResetPosition(std::string& out, bool clear = false);
 
   // Fill with space.
   void Clear();
@@ -84,7 +111,11 @@ class Screen {
  protected:
   int dimx_;
   int dimy_;
-  std::vector<std::vector<Pixel>> pixels_;
+  std::vector<Pixel> pixels_;  // dimy_ rows of dimx_ pixels.
+  // The hash of every row, computed by SerializeScroll() and reused when this
+  // Screen is the |previous| one. Cleared by Clear().
+  std::vector<uint64_t> row_hashes_;
+  OutputMode output_mode_;
   Cursor cursor_;
 };
 
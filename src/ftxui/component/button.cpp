@@ -30,7 +30,7 @@ class ButtonBase : public ComponentBase {
     return text(*label_) | my_border | style | reflect(box_);
   }
 
-  bool OnEvent(Event event) override {
+  bool OnEvent(const Event& event) override {
     if (event.is_mouse() && box_.Contain(event.mouse().x, event.mouse().y)) {
       if (!CaptureMouse(event))
         return false;
@@ -11,11 +11,11 @@ namespace ftxui {
 class CatchEventBase : public ComponentBase {
  public:
   // Constructor.
-  CatchEventBase(std::function<bool(Event)> on_event)
+  CatchEventBase(std::function<bool(const Event&)> on_event)
       : on_event_(std::move(on_event)) {}
 
   // Component implementation.
-  bool OnEvent(Event event) override {
+  bool OnEvent(const Event& event) override {
     if (on_event_(event))
       return true;
     else
@@ -23,7 +23,7 @@ class CatchEventBase : public ComponentBase {
   }
 
  protected:
-  std::function<bool(Event)> on_event_;
+  std::function<bool(const Event&)> on_event_;
 };
 
 /// @brief Return a component, using |on_event| to catch events. This function
@@ -42,7 +42,7 @@ class CatchEventBase : public ComponentBase {
 /// screen.Loop(renderer);
 /// ```
 Component CatchEvent(Component child,
-                     std::function<bool(Event event)> on_event) {
+                     std::function<bool(const Event&)> on_event) {
   auto out = Make<CatchEventBase>(std::move(on_event));
   out->Add(std::move(child));
   return out;
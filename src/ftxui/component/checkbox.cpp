@@ -46,7 +46,7 @@ class CheckboxBase : public ComponentBase {
            reflect(box_);
   }
 
-  bool OnEvent(Event event) override {
+  bool OnEvent(const Event& event) override {
     if (!CaptureMouse(event))
       return false;
 
@@ -63,7 +63,7 @@ class CheckboxBase : public ComponentBase {
     return false;
   }
 
-  bool OnMouseEvent(Event event) {
+  bool OnMouseEvent(const Event& event) {
     hovered_ = box_.Contain(event.mouse().x, event.mouse().y);
 
     if (!CaptureMouse(event))
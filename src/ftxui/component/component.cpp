@@ -1,5 +1,6 @@
 #include <stddef.h>   // for size_t
 #include <algorithm>  // for find_if, max
+#include <atomic>     // for atomic, memory_order_relaxed
 #include <cassert>    // for assert
 #include <iterator>   // for begin, end
 #include <utility>    // for move
@@ -9,6 +10,7 @@
 #include "ftxui/component/component.hpp"
 #include "ftxui/component/component_base.hpp"  // for ComponentBase, Component
 #include "ftxui/component/event.hpp"           // for Event
+#include "ftxui/component/hit_map.hpp"         // for HitTarget
 #include "ftxui/component/screen_interactive.hpp"  // for Component, ScreenInteractive
 #include "ftxui/dom/elements.hpp"                  // for text, Element
 
@@ -16,6 +18,21 @@ namespace ftxui {
 
 namespace {
 class CaptureMouseImpl : public CapturedMouseInterface {};
+
+// Incremented whenever the focus may have changed. The components compare it
+// with the one they cached their focus state at. Separate trees can be
+// rendered from separate threads.
+std::atomic<size_t> g_focus_generation = 1;
+
+// The number of ComponentBase::FocusCache alive on this thread.
+thread_local int g_focus_caches = 0;
+
+// Zero when the focus state must not be cached.
+size_t FocusGeneration() {
+  if (g_focus_caches == 0)
+    return 0;
+  return g_focus_generation.load(std::memory_order_relaxed);
+}
 }  // namespace
 
 ComponentBase::~ComponentBase() {
@@ -50,6 +67,7 @@ void ComponentBase::Add(Component child) {
   child->Detach();
   child->parent_ = this;
   children_.push_back(std::move(child));
+  InvalidateFocus();
 }
 
 /// @brief Detach this child from its parent.
@@ -66,6 +84,7 @@ void ComponentBase::Detach() {
                          });
   parent_->children_.erase(it);
   parent_ = nullptr;
+  InvalidateFocus();
 }
 
 /// @brief Remove all children.
@@ -81,7 +100,7 @@ void ComponentBase::DetachAllChildren() {
 /// @ingroup component
 Element ComponentBase::Render() {
   if (children_.size() == 1)
-    return children_.front()->Render();
+    return HitTarget(children_.front()->Render(), children_.front());
 
   return text("Not implemented component");
 }
@@ -92,7 +111,14 @@ Element ComponentBase::Render() {
 /// The default implementation called OnEvent on every child until one return
 /// true. If none returns true, return false.
 /// @ingroup component
-bool ComponentBase::OnEvent(Event event) {
+bool ComponentBase::OnEvent(const Event& event) {
+  // The mouse events are only forwarded to the child under the mouse, when
+  // ScreenInteractive knows it.
+  if (event.is_mouse() && event.screen_) {
+    if (ComponentBase* child = event.screen_->MouseRoute(this))
+      return child->OnEvent(event);
+  }
+
   for (Component& child : children_) {
     if (child->OnEvent(event))
       return true;
@@ -122,7 +148,7 @@ bool ComponentBase::Focusable() const {
 /// @brief Returns if the element if the currently active child of its parent.
 /// @ingroup component
 bool ComponentBase::Active() const {
-  return !parent_ || parent_->ActiveChild().get() == this;
+  return !parent_ || parent_->ActiveChildCached() == this;
 }
 
 /// @brief Returns if the elements if focused by the user.
@@ -130,11 +156,53 @@ bool ComponentBase::Active() const {
 /// when it is with all its ancestors the ActiveChild() of their parents.
 /// @ingroup component
 bool ComponentBase::Focused() const {
-  auto current = this;
-  while (current && current->Active()) {
-    current = current->parent_;
+  const size_t generation = FocusGeneration();
+  if (generation == 0 || focused_generation_ != generation) {
+    // The parent's state is cached too. Rendering a tree is thus linear in its
+    // size, instead of walking to the root from every component.
+    focused_ = !parent_ || (parent_->ActiveChildCached() == this &&  //
+                            parent_->Focused());
+    focused_generation_ = generation;
+  }
+  return focused_;
+}
+
+/// @brief Cache the Active() and Focused() states while alive, on the calling
+/// thread. The cache starts empty.
+/// @ingroup component
+ComponentBase::FocusCache::FocusCache() {
+  g_focus_caches++;
+  InvalidateFocus();
+}
+
+ComponentBase::FocusCache::~FocusCache() {
+  g_focus_caches--;
+}
+
+/// @brief Forget the cached Active() and Focused() states of every component.
+/// Call it after changing what ActiveChild() returns, outside of
+/// SetActiveChild(), while a FocusCache exists.
+/// @ingroup component
+void ComponentBase::InvalidateFocus() {
+  g_focus_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+/// @brief Called when the component gains or loses the focus.
+/// @param focused Whether the component is now focused.
+/// ScreenInteractive compares the focused components with the ones of the
+/// previous check, after handling the events, tasks and timers. The
+/// components losing the focus are notified first, the innermost first.
+/// @ingroup component
+void ComponentBase::OnFocusChange(bool) {}
+
+ComponentBase* ComponentBase::ActiveChildCached() const {
+  const size_t generation = FocusGeneration();
+  if (generation == 0 || active_child_generation_ != generation) {
+    // ActiveChild() is not const, only because it returns a mutable child.
+    active_child_ = const_cast<ComponentBase*>(this)->ActiveChild().get();
+    active_child_generation_ = generation;
   }
-  return !current;
+  return active_child_;
 }
 
 /// @brief Make the |child| to be the "active" one.
@@ -147,6 +215,7 @@ void ComponentBase::SetActiveChild(ComponentBase*) {}
 /// @ingroup component
 void ComponentBase::SetActiveChild(Component child) {
   SetActiveChild(child.get());
+  InvalidateFocus();
 }
 
 /// @brief Configure all the ancestors to give focus to this component.
@@ -157,6 +226,7 @@ void ComponentBase::TakeFocus() {
     parent->SetActiveChild(child);
     child = parent;
   }
+  InvalidateFocus();
 }
 
 /// @brief Take the CapturedMouse if available. There is only one component of
@@ -165,7 +235,7 @@ void ComponentBase::TakeFocus() {
 /// @ingroup component
 CapturedMouse ComponentBase::CaptureMouse(const Event& event) {
   if (event.screen_)
-    return event.screen_->CaptureMouse();
+    return event.screen_->CaptureMouse(this);
   return std::make_unique<CaptureMouseImpl>();
 }
 
@@ -7,6 +7,7 @@
 #include "ftxui/component/component.hpp"  // for Horizontal, Vertical, Tab
 #include "ftxui/component/component_base.hpp"  // for Components, Component, ComponentBase
 #include "ftxui/component/event.hpp"  // for Event, Event::Tab, Event::TabReverse, Event::ArrowDown, Event::ArrowLeft, Event::ArrowRight, Event::ArrowUp
+#include "ftxui/component/hit_map.hpp"  // for HitTarget
 #include "ftxui/component/mouse.hpp"  // for Mouse, Mouse::WheelDown, Mouse::WheelUp
 #include "ftxui/dom/elements.hpp"  // for text, Elements, operator|, reflect, Element, hbox, vbox
 #include "ftxui/screen/box.hpp"  // for Box
@@ -22,7 +23,7 @@ class ContainerBase : public ComponentBase {
   }
 
   // Component override.
-  bool OnEvent(Event event) override {
+  bool OnEvent(const Event& event) override {
     if (event.is_mouse())
       return OnMouseEvent(event);
 
@@ -46,6 +47,7 @@ class ContainerBase : public ComponentBase {
     for (size_t i = 0; i < children_.size(); ++i) {
       if (children_[i].get() == child) {
         *selector_ = i;
+        InvalidateFocus();
         return;
       }
     }
@@ -53,9 +55,9 @@ class ContainerBase : public ComponentBase {
 
  protected:
   // Handlers
-  virtual bool EventHandler(Event) { return false; }
+  virtual bool EventHandler(const Event&) { return false; }
 
-  virtual bool OnMouseEvent(Event event) {
+  virtual bool OnMouseEvent(const Event& event) {
     return ComponentBase::OnEvent(event);
   }
 
@@ -67,6 +69,7 @@ class ContainerBase : public ComponentBase {
          i += dir) {
       if (children_[i]->Focusable()) {
         *selector_ = i;
+        InvalidateFocus();
         return;
       }
     }
@@ -76,6 +79,7 @@ class ContainerBase : public ComponentBase {
       int i = (*selector_ + offset * dir + children_.size()) % children_.size();
       if (children_[i]->Focusable()) {
         *selector_ = i;
+        InvalidateFocus();
         return;
       }
     }
@@ -89,13 +93,13 @@ class VerticalContainer : public ContainerBase {
   Element Render() override {
     Elements elements;
     for (auto& it : children_)
-      elements.push_back(it->Render());
+      elements.push_back(HitTarget(it->Render(), it));
     if (elements.size() == 0)
       return text("Empty container") | reflect(box_);
     return vbox(std::move(elements)) | reflect(box_);
   }
 
-  bool EventHandler(Event event) override {
+  bool EventHandler(const Event& event) override {
     int old_selected = *selector_;
     if (event == Event::ArrowUp || event == Event::Character('k'))
       MoveSelector(-1);
@@ -126,7 +130,7 @@ class VerticalContainer : public ContainerBase {
     return old_selected != *selector_;
   }
 
-  bool OnMouseEvent(Event event) override {
+  bool OnMouseEvent(const Event& event) override {
     if (ContainerBase::OnMouseEvent(event))
       return true;
 
@@ -157,13 +161,13 @@ class HorizontalContainer : public ContainerBase {
   Element Render() override {
     Elements elements;
     for (auto& it : children_)
-      elements.push_back(it->Render());
+      elements.push_back(HitTarget(it->Render(), it));
     if (elements.size() == 0)
       return text("Empty container");
     return hbox(std::move(elements));
   }
 
-  bool EventHandler(Event event) override {
+  bool EventHandler(const Event& event) override {
     int old_selected = *selector_;
     if (event == Event::ArrowLeft || event == Event::Character('h'))
       MoveSelector(-1);
@@ -186,11 +190,11 @@ class TabContainer : public ContainerBase {
   Element Render() override {
     Component active_child = ActiveChild();
     if (active_child)
-      return active_child->Render();
+      return HitTarget(active_child->Render(), active_child);
     return text("Empty container");
   }
 
-  bool OnMouseEvent(Event event) override {
+  bool OnMouseEvent(const Event& event) override {
     return ActiveChild()->OnEvent(event);
   }
 };
@@ -223,6 +223,31 @@ TEST(ContainerTest, SetActiveChild) {
   EXPECT_FALSE(c2->Active());
 }
 
+TEST(ContainerTest, SelectorWrittenExternally) {
+  int selector = 0;
+  auto c0 = Focusable();
+  auto c1 = Focusable();
+  auto container = Container::Tab({c0, c1}, &selector);
+  EXPECT_TRUE(c0->Focused());
+  EXPECT_FALSE(c1->Focused());
+
+  selector = 1;
+  EXPECT_FALSE(c0->Focused());
+  EXPECT_TRUE(c1->Focused());
+  EXPECT_FALSE(c0->Active());
+  EXPECT_TRUE(c1->Active());
+
+  // While a FocusCache exists, the focus is cached until invalidated.
+  ComponentBase::FocusCache focus_cache;
+  EXPECT_TRUE(c1->Focused());
+  selector = 0;
+  EXPECT_FALSE(c0->Focused());
+  EXPECT_TRUE(c1->Focused());
+  ComponentBase::InvalidateFocus();
+  EXPECT_TRUE(c0->Focused());
+  EXPECT_FALSE(c1->Focused());
+}
+
 TEST(ContainerTest, TakeFocus) {
   auto c = Container::Horizontal({});
   auto c1 = Container::Vertical({});
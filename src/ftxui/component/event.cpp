@@ -1,4 +1,6 @@
-#include <utility>  // for move
+#include <string.h>    // for memcpy
+#include <functional>  // for hash
+#include <utility>     // for move
 
 #include "ftxui/component/event.hpp"
 #include "ftxui/component/mouse.hpp"  // for Mouse
@@ -6,11 +8,216 @@
 
 namespace ftxui {
 
+namespace {
+
+using Key = Event::Key;
+
+#if defined(_WIN32)
+const char kReturn = 13;
+#else
+const char kReturn = 10;
+#endif
+
+// The keys identified by the final byte of "ESC O x" and "CSI 1 ; m x".
+Key FinalKey(char c) {
+  switch (c) {
+    case 'A':
+      return Key::ArrowUp;
+    case 'B':
+      return Key::ArrowDown;
+    case 'C':
+      return Key::ArrowRight;
+    case 'D':
+      return Key::ArrowLeft;
+    case 'H':
+      return Key::Home;
+    case 'F':
+      return Key::End;
+    case 'P':
+      return Key::F1;
+    case 'Q':
+      return Key::F2;
+    case 'R':
+      return Key::F3;
+    case 'S':
+      return Key::F4;
+    case 'Z':
+      return Key::TabReverse;
+    default:
+      return Key::Unknown;
+  }
+}
+
+// The keys identified by the number of "CSI n ; m ~".
+Key TildeKey(int n) {
+  switch (n) {
+    case 1:
+    case 7:
+      return Key::Home;
+    case 3:
+      return Key::Delete;
+    case 4:
+    case 8:
+      return Key::End;
+    case 5:
+      return Key::PageUp;
+    case 6:
+      return Key::PageDown;
+    case 11:
+      return Key::F1;
+    case 12:
+      return Key::F2;
+    case 13:
+      return Key::F3;
+    case 14:
+      return Key::F4;
+    case 15:
+      return Key::F5;
+    case 17:
+      return Key::F6;
+    case 18:
+      return Key::F7;
+    case 19:
+      return Key::F8;
+    case 20:
+      return Key::F9;
+    case 21:
+      return Key::F10;
+    case 23:
+      return Key::F11;
+    case 24:
+      return Key::F12;
+    default:
+      return Key::Unknown;
+  }
+}
+
+// Identify the key encoded by |input|, and its modifiers. Returns
+// Key::Unknown for any other sequence.
+Key Identify(const std::string& input, uint8_t* modifiers) {
+  const size_t size = input.size();
+  if (size == 1) {
+    switch (input[0]) {
+      case 0:
+        return Key::Custom;
+      case 9:
+        return Key::Tab;
+      case kReturn:
+        return Key::Return;
+      case 27:
+        return Key::Escape;
+      case 127:
+        return Key::Backspace;
+      default:
+        return Key::Unknown;
+    }
+  }
+
+  if (size < 3 || input[0] != '\x1B')
+    return Key::Unknown;
+
+  // SS3: ESC O x
+  if (input[1] == 'O')
+    return size == 3 ? FinalKey(input[2]) : Key::Unknown;
+
+  if (input[1] != '[')
+    return Key::Unknown;
+
+  // CSI x
+  if (size == 3)
+    return FinalKey(input[2]);
+
+  // CSI O x: the function keys used to be encoded this way.
+  if (size == 4 && input[2] == 'O')
+    return FinalKey(input[3]);
+
+  // CSI n [; m] x
+  int n = 0;
+  int m = 1;
+  size_t i = 2;
+  for (; i < size - 1 && input[i] >= '0' && input[i] <= '9' && n < 100; ++i)
+    n = n * 10 + (input[i] - '0');
+  if (i < size - 1 && input[i] == ';') {
+    ++i;
+    if (i != size - 2 || input[i] < '1' || input[i] > '8')
+      return Key::Unknown;
+    m = input[i++] - '0';
+  }
+  if (i != size - 1)
+    return Key::Unknown;
+
+  Key key = Key::Unknown;
+  if (input[i] == '~')
+    key = TildeKey(n);
+  else if (n == 1)
+    key = FinalKey(input[i]);
+  if (key != Key::Unknown)
+    *modifiers = uint8_t(m - 1);
+  return key;
+}
+
+// The canonical sequence of a key, used by Event::input().
+std::string Sequence(Key key, uint8_t modifiers) {
+  char last = 0;
+  int n = 0;
+  switch (key) {
+    // clang-format off
+    case Key::Unknown:    return "";
+    case Key::Character:  return "";
+    case Key::Backspace:  return {127};
+    case Key::Return:     return {kReturn};
+    case Key::Escape:     return "\x1B";
+    case Key::Tab:        return {9};
+    case Key::TabReverse: return "\x1B[Z";
+    case Key::Custom:     return {0};
+    case Key::ArrowUp:    last = 'A'; break;
+    case Key::ArrowDown:  last = 'B'; break;
+    case Key::ArrowRight: last = 'C'; break;
+    case Key::ArrowLeft:  last = 'D'; break;
+    case Key::Home:       last = 'H'; break;
+    case Key::End:        last = 'F'; break;
+    case Key::F1:         last = 'P'; break;
+    case Key::F2:         last = 'Q'; break;
+    case Key::F3:         last = 'R'; break;
+    case Key::F4:         last = 'S'; break;
+    case Key::Delete:     n = 3; break;
+    case Key::PageUp:     n = 5; break;
+    case Key::PageDown:   n = 6; break;
+    case Key::F5:         n = 15; break;
+    case Key::F6:         n = 17; break;
+    case Key::F7:         n = 18; break;
+    case Key::F8:         n = 19; break;
+    case Key::F9:         n = 20; break;
+    case Key::F10:        n = 21; break;
+    case Key::F11:        n = 23; break;
+    case Key::F12:        n = 24; break;
+    // clang-format on
+  }
+
+  const std::string modifier =
+      modifiers ? ";" + std::to_string(modifiers + 1) : "";
+  if (n != 0)
+    return "\x1B[" + std::to_string(n) + modifier + "~";
+  if (modifiers)
+    return "\x1B[1" + modifier + last;
+  if (key >= Key::F1 && key <= Key::F4)
+    return std::string("\x1BO") + last;
+  return std::string("\x1B[") + last;
+}
+
+}  // namespace
+
 // static
 Event Event::Character(std::string input) {
   Event event;
-  event.input_ = std::move(input);
   event.type_ = Type::Character;
+  event.key_ = Key::Character;
+  if (!input.empty() && input.size() <= sizeof(event.utf8_)) {
+    memcpy(event.utf8_, input.data(), input.size());
+    event.size_ = uint8_t(input.size());
+  } else {
+    event.input_ = std::move(input);
+  }
   return event;
 }
 
@@ -36,7 +243,9 @@ Event Event::Mouse(std::string input, struct Mouse mouse) {
 // static
 Event Event::Special(std::string input) {
   Event event;
-  event.input_ = std::move(input);
+  event.key_ = Identify(input, &event.modifiers_);
+  if (event.key_ == Key::Unknown)
+    event.input_ = std::move(input);
   return event;
 }
 
@@ -50,6 +259,48 @@ Event Event::CursorReporting(std::string input, int x, int y) {
   return event;
 }
 
+namespace {
+// The pasted text is surrounded by these markers in bracketed paste mode.
+const char kPasteBegin[] = "\x1B[200~";
+const char kPasteEnd[] = "\x1B[201~";
+}  // namespace
+
+// static
+Event Event::Paste(std::string text) {
+  Event event;
+  event.input_ = kPasteBegin + std::move(text) + kPasteEnd;
+  event.type_ = Type::Paste;
+  return event;
+}
+
+std::string Event::input() const {
+  if (size_ != 0)
+    return std::string(utf8_, size_);
+  if (key_ == Key::Unknown || key_ == Key::Character)
+    return input_;
+  return Sequence(key_, modifiers_);
+}
+
+size_t Event::Hash::operator()(const Event& event) const {
+  size_t hash = size_t(event.key_) << 8 | event.modifiers_;
+  if (event.size_ != 0) {
+    uint64_t bytes;
+    memcpy(&bytes, event.utf8_, sizeof(bytes));
+    return hash ^ std::hash<uint64_t>()(bytes);
+  }
+  if (event.key_ == Key::Unknown || event.key_ == Key::Character)
+    return hash ^ std::hash<std::string>()(event.input_);
+  return hash;
+}
+
+std::string Event::paste() const {
+  if (!is_paste())
+    return "";
+  const size_t begin = sizeof(kPasteBegin) - 1;
+  const size_t end = input_.size() - (sizeof(kPasteEnd) - 1);
+  return input_.substr(begin, end - begin);
+}
+
 // --- Arrow ---
 const Event Event::ArrowLeft = Event::Special("\x1B[D");
 const Event Event::ArrowRight = Event::Special("\x1B[C");
@@ -58,24 +309,20 @@ const Event Event::ArrowDown = Event::Special("\x1B[B");
 const Event Event::Backspace = Event::Special({127});
 const Event Event::Delete = Event::Special("\x1B[3~");
 const Event Event::Escape = Event::Special("\x1B");
-#if defined(_WIN32)
-const Event Event::Return = Event::Special({13});
-#else
-const Event Event::Return = Event::Special({10});
-#endif
+const Event Event::Return = Event::Special({kReturn});
 const Event Event::Tab = Event::Special({9});
 const Event Event::TabReverse = Event::Special({27, 91, 90});
-const Event Event::F1 = Event::Special("\x1B[OP");
-const Event Event::F2 = Event::Special("\x1B[OQ");
-const Event Event::F3 = Event::Special("\x1B[OR");
-const Event Event::F4 = Event::Special("\x1B[OS");
+const Event Event::F1 = Event::Special("\x1BOP");
+const Event Event::F2 = Event::Special("\x1BOQ");
+const Event Event::F3 = Event::Special("\x1BOR");
+const Event Event::F4 = Event::Special("\x1BOS");
 const Event Event::F5 = Event::Special("\x1B[15~");
 const Event Event::F6 = Event::Special("\x1B[17~");
 const Event Event::F7 = Event::Special("\x1B[18~");
 const Event Event::F8 = Event::Special("\x1B[19~");
 const Event Event::F9 = Event::Special("\x1B[20~");
 const Event Event::F10 = Event::Special("\x1B[21~");
-const Event Event::F11 = Event::Special("\x1B[21~");  // Doesn't exist
+const Event Event::F11 = Event::Special("\x1B[23~");
 const Event Event::F12 = Event::Special("\x1B[24~");
 const Event Event::Home = Event::Special({27, 91, 72});
 const Event Event::End = Event::Special({27, 91, 70});
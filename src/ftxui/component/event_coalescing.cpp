@@ -0,0 +1,67 @@
+#include "ftxui/component/event_coalescing.hpp"
+
+#include <stddef.h>  // for size_t
+#include <utility>   // for move
+#include <variant>   // for get_if
+
+#include "ftxui/component/mouse.hpp"  // for Mouse
+
+namespace ftxui {
+
+namespace {
+
+// Only the motions are coalesced. The wheel ticks and the button presses are
+// all reported.
+bool SameMotion(const Mouse& a, const Mouse& b) {
+  return a.motion == Mouse::Moved &&  //
+         b.motion == Mouse::Moved &&  //
+         a.button == b.button &&      //
+         a.shift == b.shift &&        //
+         a.meta == b.meta &&          //
+         a.control == b.control;
+}
+
+// Whether |task| makes |previous_task| redundant. |before_task| is the task
+// preceding |previous_task|, if any. Closures are never coalesced.
+bool Supersedes(Task& task, Task& previous_task, Task* before_task) {
+  Event* event = std::get_if<Event>(&task);
+  Event* previous = std::get_if<Event>(&previous_task);
+  Event* before = before_task ? std::get_if<Event>(before_task) : nullptr;
+  if (!event || !previous)
+    return false;
+
+  if (*event == Event::Custom)
+    return *previous == Event::Custom;
+
+  if (!event->is_mouse() || !previous->is_mouse())
+    return false;
+
+  // The first event of a run is kept, it may be a transition.
+  return before && before->is_mouse() &&
+         SameMotion(event->mouse(), previous->mouse()) &&
+         SameMotion(previous->mouse(), before->mouse());
+}
+
+}  // namespace
+
+void CoalesceEvents(std::vector<Task>* tasks) {
+  size_t size = 0;
+  for (Task& task : *tasks) {
+    if (size != 0 &&
+        Supersedes(task, (*tasks)[size - 1],
+                   size >= 2 ? &(*tasks)[size - 2] : nullptr)) {
+      (*tasks)[size - 1] = std::move(task);
+      continue;
+    }
+    if (&(*tasks)[size] != &task)
+      (*tasks)[size] = std::move(task);
+    size++;
+  }
+  tasks->resize(size);
+}
+
+}  // namespace ftxui
+
+// Copyright 2021 Arthur Sonzogni. All rights reserved.
+// Use of this source code is governed by the MIT license that can be found in
+// the LICENSE file.
@@ -0,0 +1,24 @@
+#ifndef FTXUI_COMPONENT_EVENT_COALESCING
+#define FTXUI_COMPONENT_EVENT_COALESCING
+
+#include <vector>  // for vector
+
+#include "ftxui/component/task.hpp"  // for Task
+
+namespace ftxui {
+
+// Remove the redundant events from a batch of tasks, before they are
+// dispatched:
+// - A run of mouse events with the same button, motion and modifiers keeps
+//   only its first and last events. Transitions are never dropped, the
+//   intermediate positions are.
+// - A run of |Event::Custom| (also used for resizes) becomes a single one.
+void CoalesceEvents(std::vector<Task>* tasks);
+
+}  // namespace ftxui
+
+#endif /* end of include guard: FTXUI_COMPONENT_EVENT_COALESCING */
+
+// Copyright 2021 Arthur Sonzogni. All rights reserved.
+// Use of this source code is governed by the MIT license that can be found in
+// the LICENSE file.
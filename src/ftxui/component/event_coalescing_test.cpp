@@ -0,0 +1,123 @@
+#include <gtest/gtest-message.h>    // for Message
+#include <gtest/gtest-test-part.h>  // for TestPartResult
+#include <variant>                  // for get, get_if
+#include <vector>                   // for vector
+
+#include "ftxui/component/event.hpp"  // for Event, Event::Custom
+#include "ftxui/component/event_coalescing.hpp"
+#include "ftxui/component/mouse.hpp"  // for Mouse
+#include "ftxui/component/task.hpp"   // for Task
+#include "gtest/gtest_pred_impl.h"    // for AssertionResult, Test, EXPECT_EQ
+
+using namespace ftxui;
+
+namespace {
+
+Event MouseEvent(Mouse::Button button, Mouse::Motion motion, int x) {
+  Mouse mouse;
+  mouse.button = button;
+  mouse.motion = motion;
+  mouse.shift = false;
+  mouse.meta = false;
+  mouse.control = false;
+  mouse.x = x;
+  mouse.y = 0;
+  return Event::Mouse("mouse", mouse);
+}
+
+}  // namespace
+
+TEST(EventCoalescing, MouseMotion) {
+  std::vector<Task> tasks = {
+      MouseEvent(Mouse::None, Mouse::Moved, 1),
+      MouseEvent(Mouse::None, Mouse::Moved, 2),
+      MouseEvent(Mouse::None, Mouse::Moved, 3),
+      MouseEvent(Mouse::Left, Mouse::Pressed, 4),
+      MouseEvent(Mouse::Left, Mouse::Moved, 5),
+      MouseEvent(Mouse::Left, Mouse::Moved, 6),
+      MouseEvent(Mouse::Left, Mouse::Moved, 7),
+      MouseEvent(Mouse::Left, Mouse::Released, 8),
+      MouseEvent(Mouse::Left, Mouse::Pressed, 9),
+      MouseEvent(Mouse::Left, Mouse::Released, 10),
+  };
+  CoalesceEvents(&tasks);
+
+  // The transitions are kept, with the last position of every run.
+  std::vector<int> x;
+  for (Task& task : tasks)
+    x.push_back(std::get<Event>(task).mouse().x);
+  EXPECT_EQ(x, std::vector<int>({1, 3, 4, 5, 7, 8, 9, 10}));
+}
+
+TEST(EventCoalescing, KeepWheelAndPresses) {
+  std::vector<Task> tasks = {
+      MouseEvent(Mouse::WheelUp, Mouse::Pressed, 1),
+      MouseEvent(Mouse::WheelUp, Mouse::Pressed, 2),
+      MouseEvent(Mouse::WheelUp, Mouse::Pressed, 3),
+      MouseEvent(Mouse::WheelUp, Mouse::Pressed, 4),
+      MouseEvent(Mouse::WheelDown, Mouse::Pressed, 5),
+      MouseEvent(Mouse::WheelDown, Mouse::Pressed, 6),
+      MouseEvent(Mouse::WheelDown, Mouse::Pressed, 7),
+      MouseEvent(Mouse::Left, Mouse::Pressed, 8),
+      MouseEvent(Mouse::Left, Mouse::Pressed, 9),
+      MouseEvent(Mouse::Left, Mouse::Pressed, 10),
+  };
+  CoalesceEvents(&tasks);
+
+  // Every wheel tick and every press is reported.
+  std::vector<int> x;
+  for (Task& task : tasks)
+    x.push_back(std::get<Event>(task).mouse().x);
+  EXPECT_EQ(x, std::vector<int>({1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+}
+
+TEST(EventCoalescing, Custom) {
+  std::vector<Task> tasks = {
+      Event::Custom,         Event::Custom, Event::Character('a'),
+      Event::Custom,         Event::Custom, Event::Custom,
+      Event::Character('a'),
+  };
+  CoalesceEvents(&tasks);
+
+  std::vector<Event> expected = {
+      Event::Custom,
+      Event::Character('a'),
+      Event::Custom,
+      Event::Character('a'),
+  };
+  ASSERT_EQ(tasks.size(), expected.size());
+  for (size_t i = 0; i < tasks.size(); ++i)
+    EXPECT_EQ(std::get<Event>(tasks[i]), expected[i]);
+}
+
+TEST(EventCoalescing, KeepClosures) {
+  int executed = 0;
+  std::vector<Task> tasks = {
+      Event::Custom,
+      [&] { executed++; },
+      Event::Custom,
+      [&] { executed++; },
+      [&] { executed++; },
+  };
+  CoalesceEvents(&tasks);
+  EXPECT_EQ(tasks.size(), 5u);
+  for (Task& task : tasks) {
+    if (auto* closure = std::get_if<Closure>(&task))
+      (*closure)();
+  }
+  EXPECT_EQ(executed, 3);
+}
+
+TEST(EventCoalescing, KeepCharacters) {
+  std::vector<Task> tasks = {
+      Event::Character('a'),
+      Event::Character('a'),
+      Event::Character('a'),
+  };
+  CoalesceEvents(&tasks);
+  EXPECT_EQ(tasks.size(), 3u);
+}
+
+// Copyright 2021 Arthur Sonzogni. All rights reserved.
+// Use of this source code is governed by the MIT license that can be found in
+// the LICENSE file.
@@ -0,0 +1,70 @@
+#include <gtest/gtest-message.h>  // for Message
+#include <gtest/gtest-test-part.h>  // for TestPartResult, SuiteApiResolver, TestFactoryImpl
+#include <string>                   // for string
+
+#include "ftxui/component/event.hpp"  // for Event, Event::Key
+#include "gtest/gtest_pred_impl.h"  // for AssertionResult, EXPECT_EQ, Test, EXPECT_TRUE, EXPECT_FALSE, TEST
+
+using namespace ftxui;
+
+TEST(EventTest, KnownKeys) {
+  EXPECT_EQ(Event::ArrowLeft.key(), Event::Key::ArrowLeft);
+  EXPECT_EQ(Event::Return.key(), Event::Key::Return);
+  EXPECT_EQ(Event::F11.key(), Event::Key::F11);
+  EXPECT_EQ(Event::Custom.key(), Event::Key::Custom);
+  EXPECT_NE(Event::F10, Event::F11);
+
+  // The keys have several encodings.
+  EXPECT_EQ(Event::Special("\x1BOD"), Event::ArrowLeft);
+  EXPECT_EQ(Event::Special("\x1B[1~"), Event::Home);
+  EXPECT_EQ(Event::Special("\x1B[OP"), Event::F1);
+  EXPECT_EQ(Event::Special("\x1B[11~"), Event::F1);
+
+  // Their input is the canonical one.
+  EXPECT_EQ(Event::Special("\x1BOD").input(), "\x1B[D");
+  EXPECT_EQ(Event::F1.input(), "\x1BOP");
+}
+
+TEST(EventTest, Modifiers) {
+  const Event control_left = Event::Special("\x1B[1;5D");
+  EXPECT_EQ(control_left.key(), Event::Key::ArrowLeft);
+  EXPECT_TRUE(control_left.control());
+  EXPECT_FALSE(control_left.shift());
+  EXPECT_FALSE(control_left.alt());
+  EXPECT_NE(control_left, Event::ArrowLeft);
+  EXPECT_EQ(control_left.input(), "\x1B[1;5D");
+
+  const Event shift_alt_delete = Event::Special("\x1B[3;4~");
+  EXPECT_EQ(shift_alt_delete.key(), Event::Key::Delete);
+  EXPECT_TRUE(shift_alt_delete.shift());
+  EXPECT_TRUE(shift_alt_delete.alt());
+  EXPECT_EQ(shift_alt_delete.input(), "\x1B[3;4~");
+}
+
+TEST(EventTest, Character) {
+  EXPECT_EQ(Event::Character('a'), Event::Character("a"));
+  EXPECT_NE(Event::Character('a'), Event::Character('b'));
+  EXPECT_EQ(Event::Character("€").character(), "€");
+  EXPECT_EQ(Event::Character("a").key(), Event::Key::Character);
+
+  // Characters too long to be stored inline.
+  const std::string family = "👨‍👩‍👧";
+  EXPECT_EQ(Event::Character(family), Event::Character(family));
+  EXPECT_NE(Event::Character(family), Event::Character("👨"));
+  EXPECT_EQ(Event::Character(family).character(), family);
+}
+
+TEST(EventTest, Unknown) {
+  const Event alt_a = Event::Special("\x1B" "a");
+  EXPECT_EQ(alt_a.key(), Event::Key::Unknown);
+  EXPECT_EQ(alt_a, Event::Special("\x1B" "a"));
+  EXPECT_NE(alt_a, Event::Special("\x1B" "b"));
+  EXPECT_NE(alt_a, Event::Escape);
+  EXPECT_EQ(alt_a.input(), "\x1B" "a");
+  EXPECT_EQ(Event::Special("\x1B[200~").key(), Event::Key::Unknown);
+  EXPECT_EQ(Event::Special("\x1B[1;9D").key(), Event::Key::Unknown);
+}
+
+// Copyright 2021 Arthur Sonzogni. All rights reserved.
+// Use of this source code is governed by the MIT license that can be found in
+// the LICENSE file.
@@ -0,0 +1,139 @@
+#include "ftxui/component/frame_writer.hpp"
+
+#include <charconv>  // for to_chars
+#include <utility>   // for move, swap
+
+namespace ftxui {
+
+namespace {
+
+// Synchronized update. The terminal displays the frame once complete.
+const char BEGIN_SYNCHRONIZED_UPDATE[] = "\x1B[?2026h";
+const char END_SYNCHRONIZED_UPDATE[] = "\x1B[?2026l";
+
+// Append the CSI sequence moving the cursor by |count| cells, without
+// allocating.
+void AppendCursorMove(std::string& out, int count, char direction) {
+  char number[16];
+  const auto result = std::to_chars(number, number + sizeof(number), count);
+  out += "\x1B[";
+  out.append(number, result.ptr);
+  out += direction;
+}
+
+}  // namespace
+
+FrameWriter::FrameWriter(Output output) : output_(std::move(output)) {
+  thread_ = std::thread([this] { Run(); });
+}
+
+FrameWriter::~FrameWriter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    quit_ = true;
+  }
+  condition_.notify_all();
+  thread_.join();
+}
+
+void FrameWriter::Send(const Screen& screen,
+                       const std::string& requests,
+                       Options options) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (has_pending_)
+      ++dropped_frames_;
+    pending_ = screen;
+    pending_requests_ += requests;
+    pending_options_ = options;
+    has_pending_ = true;
+  }
+  condition_.notify_all();
+}
+
+void FrameWriter::Flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  condition_.wait(lock, [&] { return !has_pending_ && !busy_; });
+}
+
+std::string FrameWriter::reset_cursor_position() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  condition_.wait(lock, [&] { return !has_pending_ && !busy_; });
+  return reset_cursor_position_;
+}
+
+void FrameWriter::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    condition_.wait(lock, [&] { return has_pending_ || quit_; });
+    if (!has_pending_)
+      return;
+
+    // Take the pending frame. The storage is exchanged, not copied.
+    std::swap(pending_, frame_);
+    std::swap(pending_requests_, requests_);
+    pending_requests_.clear();
+    const Options options = pending_options_;
+    has_pending_ = false;
+    busy_ = true;
+
+    lock.unlock();
+    Write(options);
+    lock.lock();
+
+    busy_ = false;
+    condition_.notify_all();
+  }
+}
+
+void FrameWriter::Write(Options options) {
+  buffer_.clear();
+  if (options.synchronized_update)
+    buffer_ += BEGIN_SYNCHRONIZED_UPDATE;
+
+  // Move the cursor back to the top-left corner of the displayed frame. Its
+  // content is erased if the dimensions changed.
+  const bool resized = displayed_.dimx() != frame_.dimx() ||
+                       displayed_.dimy() != frame_.dimy();
+  buffer_ += reset_cursor_position_;
+  displayed_.ResetPosition(buffer_, /*clear=*/resized);
+
+  buffer_ += requests_;
+
+  // Only the cells modified since the displayed frame are printed, unless the
+  // terminal content had to be erased.
+  if (resized) {
+    frame_.Serialize(buffer_);
+  } else {
+    if (options.scroll)
+      frame_.SerializeScroll(displayed_, buffer_);
+    frame_.Serialize(displayed_, buffer_);
+  }
+
+  // Set cursor position for user using tools to insert CJK characters.
+  reset_cursor_position_.clear();
+  const int dx = frame_.dimx() - 1 - frame_.cursor().x;
+  const int dy = frame_.dimy() - 1 - frame_.cursor().y;
+  if (dx != 0) {
+    AppendCursorMove(buffer_, dx, 'D');
+    AppendCursorMove(reset_cursor_position_, dx, 'C');
+  }
+  if (dy != 0) {
+    AppendCursorMove(buffer_, dy, 'A');
+    AppendCursorMove(reset_cursor_position_, dy, 'B');
+  }
+
+  if (options.synchronized_update)
+    buffer_ += END_SYNCHRONIZED_UPDATE;
+
+  output_(buffer_);
+  last_frame_bytes_ = buffer_.size();
+
+  std::swap(displayed_, frame_);
+}
+
+}  // namespace ftxui
+
+// Copyright 2021 Arthur Sonzogni. All rights reserved.
+// Use of this source code is governed by the MIT license that can be found in
+// the LICENSE file.
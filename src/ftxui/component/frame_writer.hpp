@@ -0,0 +1,85 @@
+#ifndef FTXUI_COMPONENT_FRAME_WRITER
+#define FTXUI_COMPONENT_FRAME_WRITER
+
+#include <stddef.h>            // for size_t
+#include <atomic>              // for atomic
+#include <condition_variable>  // for condition_variable
+#include <functional>          // for function
+#include <mutex>               // for mutex
+#include <string>              // for string
+#include <thread>              // for thread
+
+#include "ftxui/screen/screen.hpp"  // for Screen
+
+namespace ftxui {
+
+// Send frames to the terminal from a dedicated thread, so that a slow terminal
+// never blocks the caller. When the terminal can't keep up, the frame waiting
+// to be sent is replaced by the newest one. Frames are sent as differences
+// with the one displayed by the terminal, so dropping them is safe.
+class FrameWriter {
+ public:
+  using Output = std::function<void(const std::string&)>;
+  FrameWriter(Output output);
+  // Send the frame not yet sent, then stop.
+  ~FrameWriter();
+
+  struct Options {
+    // Wrap the frame into a synchronized update (DEC mode 2026).
+    bool synchronized_update = false;
+    // Use Screen::SerializeScroll(). The frame must cover the whole terminal.
+    bool scroll = false;
+  };
+
+  // Queue |screen| to be sent, replacing the frame not yet sent. The
+  // |requests| are sent before the frame. Unlike frames, they are never
+  // dropped.
+  void Send(const Screen& screen, const std::string& requests, Options options);
+
+  // Wait for the queued frame to be sent.
+  void Flush();
+
+  // Wait for the queued frame to be sent. Returns the sequence moving the
+  // cursor from where the frame left it to its bottom-right corner.
+  std::string reset_cursor_position();
+
+  // The number of bytes sent for the last frame.
+  size_t last_frame_bytes() const { return last_frame_bytes_; }
+  // The number of frames replaced by newer ones before being sent.
+  int dropped_frames() const { return dropped_frames_; }
+
+ private:
+  void Run();
+  void Write(Options options);
+
+  Output output_;
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool quit_ = false;
+  bool busy_ = false;
+  bool has_pending_ = false;
+  Screen pending_ = Screen(0, 0);
+  std::string pending_requests_;
+  Options pending_options_;
+
+  // Owned by the writing thread:
+  Screen frame_ = Screen(0, 0);
+  Screen displayed_ = Screen(0, 0);
+  std::string requests_;
+  std::string buffer_;
+  std::string reset_cursor_position_;
+
+  std::atomic<size_t> last_frame_bytes_ = 0;
+  std::atomic<int> dropped_frames_ = 0;
+
+  std::thread thread_;
+};
+
+}  // namespace ftxui
+
+#endif /* end of include guard: FTXUI_COMPONENT_FRAME_WRITER */
+
+// Copyright 2021 Arthur Sonzogni. All rights reserved.
+// Use of this source code is governed by the MIT license that can be found in
+// the LICENSE file.
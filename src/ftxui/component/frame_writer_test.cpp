@@ -0,0 +1,79 @@
+#include <gtest/gtest-message.h>    // for Message
+#include <gtest/gtest-test-part.h>  // for TestPartResult
+#include <condition_variable>       // for condition_variable
+#include <mutex>                    // for mutex, unique_lock, lock_guard
+#include <string>                   // for string
+#include <vector>                   // for vector
+
+#include "ftxui/component/frame_writer.hpp"
+#include "ftxui/screen/screen.hpp"  // for Screen
+#include "gtest/gtest_pred_impl.h"  // for AssertionResult, Test, EXPECT_EQ
+
+using namespace ftxui;
+
+TEST(FrameWriter, SendDifferences) {
+  std::vector<std::string> output;
+  {
+    FrameWriter writer([&](const std::string& frame) {
+      output.push_back(frame);
+    });
+
+    Screen screen(2, 1);
+    screen.SetCursor({1, 0});
+    screen.at(0, 0) = "a";
+    writer.Send(screen, "", {});
+    writer.Flush();
+
+    screen.at(1, 0) = "b";
+    writer.Send(screen, "", {});
+  }
+
+  ASSERT_EQ(output.size(), 2u);
+  EXPECT_EQ(output[0], "\r\x1B[2Ka ");
+  EXPECT_EQ(output[1], "\rab\x1B[2G");
+}
+
+TEST(FrameWriter, DropSupersededFrames) {
+  std::mutex mutex;
+  std::condition_variable condition;
+  bool blocked = true;
+  std::vector<std::string> output;
+
+  // The terminal blocks on the first frame, until released.
+  FrameWriter writer([&](const std::string& frame) {
+    std::unique_lock<std::mutex> lock(mutex);
+    output.push_back(frame);
+    condition.notify_all();
+    condition.wait(lock, [&] { return !blocked; });
+  });
+
+  Screen screen(3, 1);
+  screen.SetCursor({2, 0});
+  writer.Send(screen, "", {});
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [&] { return output.size() == 1; });
+  }
+
+  screen.at(0, 0) = "a";
+  writer.Send(screen, "[request 1]", {});
+  screen.at(0, 0) = "b";
+  writer.Send(screen, "[request 2]", {});
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    blocked = false;
+  }
+  condition.notify_all();
+  writer.Flush();
+
+  // The second frame is dropped, not its request. The third one is sent as a
+  // difference with the first one.
+  EXPECT_EQ(writer.dropped_frames(), 1);
+  ASSERT_EQ(output.size(), 2u);
+  EXPECT_EQ(output[1], "\r[request 1][request 2]b\x1B[3G");
+}
+
+// Copyright 2021 Arthur Sonzogni. All rights reserved.
+// Use of this source code is governed by the MIT license that can be found in
+// the LICENSE file.
@@ -0,0 +1,87 @@
+#include "ftxui/component/hit_map.hpp"
+
+#include <algorithm>  // for fill, max, min
+#include <utility>    // for move
+
+#include "ftxui/dom/node.hpp"         // for Node
+#include "ftxui/dom/requirement.hpp"  // for Requirement
+#include "ftxui/screen/screen.hpp"    // for Screen
+
+namespace ftxui {
+
+namespace {
+
+// The map being filled. Drawing happens on the thread running the loop.
+thread_local HitMap* g_hit_map = nullptr;
+
+class HitTargetNode : public Node {
+ public:
+  HitTargetNode(Element child, std::weak_ptr<ComponentBase> component)
+      : Node({std::move(child)}), component_(std::move(component)) {}
+
+  void ComputeRequirement() final {
+    Node::ComputeRequirement();
+    requirement_ = children_[0]->requirement();
+  }
+
+  void SetBox(Box box) final {
+    Node::SetBox(box);
+    children_[0]->SetBox(box);
+  }
+
+  void Render(Screen& screen) final {
+    if (g_hit_map)
+      g_hit_map->Paint(Box::Intersection(box_, screen.stencil), component_);
+    Node::Render(screen);
+  }
+
+ private:
+  std::weak_ptr<ComponentBase> component_;
+};
+
+}  // namespace
+
+void HitMap::Start(int dimx, int dimy) {
+  dimx_ = dimx;
+  dimy_ = dimy;
+  cells_.assign(dimx * dimy, 0);
+  components_.clear();
+  g_hit_map = this;
+}
+
+void HitMap::Stop() {
+  g_hit_map = nullptr;
+}
+
+Component HitMap::At(int x, int y) const {
+  if (x < 0 || x >= dimx_ || y < 0 || y >= dimy_)
+    return nullptr;
+  const uint32_t index = cells_[y * dimx_ + x];
+  return index ? components_[index - 1].lock() : nullptr;
+}
+
+void HitMap::Paint(Box box, const std::weak_ptr<ComponentBase>& component) {
+  box.x_min = std::max(box.x_min, 0);
+  box.y_min = std::max(box.y_min, 0);
+  box.x_max = std::min(box.x_max, dimx_ - 1);
+  box.y_max = std::min(box.y_max, dimy_ - 1);
+  if (box.x_min > box.x_max || box.y_min > box.y_max)
+    return;
+
+  components_.push_back(component);
+  const uint32_t index = components_.size();
+  for (int y = box.y_min; y <= box.y_max; ++y) {
+    auto row = cells_.begin() + y * dimx_;
+    std::fill(row + box.x_min, row + box.x_max + 1, index);
+  }
+}
+
+Element HitTarget(Element child, const Component& component) {
+  return std::make_shared<HitTargetNode>(std::move(child), component);
+}
+
+}  // namespace ftxui
+
+// Copyright 2021 Arthur Sonzogni. All rights reserved.
+// Use of this source code is governed by the MIT license that can be found in
+// the LICENSE file.
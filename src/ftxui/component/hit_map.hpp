@@ -0,0 +1,48 @@
+#ifndef FTXUI_COMPONENT_HIT_MAP_HPP
+#define FTXUI_COMPONENT_HIT_MAP_HPP
+
+#include <stdint.h>  // for uint32_t
+#include <memory>    // for weak_ptr
+#include <vector>    // for vector
+
+#include "ftxui/component/component_base.hpp"  // for Component, ComponentBase
+#include "ftxui/dom/elements.hpp"              // for Element
+#include "ftxui/screen/box.hpp"                // for Box
+
+namespace ftxui {
+
+// The component drawn on each cell of the screen, so that a mouse event can be
+// routed directly to the component under the mouse. It is filled while
+// drawing, by the elements returned by HitTarget().
+class HitMap {
+ public:
+  // Forget the previous frame. Until Stop(), the HitTarget() elements drawn
+  // are recorded into this map.
+  void Start(int dimx, int dimy);
+  void Stop();
+
+  // The innermost component drawn on (x, y), or null.
+  Component At(int x, int y) const;
+
+  // Record |component| as drawn on |box|, over the components drawn before.
+  void Paint(Box box, const std::weak_ptr<ComponentBase>& component);
+
+ private:
+  int dimx_ = 0;
+  int dimy_ = 0;
+  // Index into |components_|, plus one. Zero means no component.
+  std::vector<uint32_t> cells_;
+  std::vector<std::weak_ptr<ComponentBase>> components_;
+};
+
+// Draw |child|, and record its cells as belonging to |component| into the
+// HitMap being filled, if any.
+Element HitTarget(Element child, const Component& component);
+
+}  // namespace ftxui
+
+#endif /* end of include guard: FTXUI_COMPONENT_HIT_MAP_HPP */
+
+// Copyright 2021 Arthur Sonzogni. All rights reserved.
+// Use of this source code is governed by the MIT license that can be found in
+// the LICENSE file.
@@ -1,4 +1,4 @@
-#include <algorithm>   // for max, min
+#include <algorithm>   // for max, min, remove_if
 #include <functional>  // for function
 #include <memory>      // for shared_ptr, allocator
 #include <string>      // for wstring, basic_string
@@ -85,7 +85,7 @@ class WideInputBase : public ComponentBase {
     // clang-format on
   }
 
-  bool OnEvent(Event event) override {
+  bool OnEvent(const Event& event) override {
     cursor_position() =
         std::max(0, std::min<int>(content_->size(), cursor_position()));
 
@@ -144,6 +144,23 @@ class WideInputBase : public ComponentBase {
       return true;
     }
 
+    // Pasted text, inserted at once. The line breaks and other control
+    // characters are dropped, the input being a single line.
+    if (event.is_paste()) {
+      std::wstring text = to_wstring(event.paste());
+      text.erase(std::remove_if(text.begin(), text.end(),
+                                [](wchar_t character) {
+                                  return character < 32 || character == 127;
+                                }),
+                 text.end());
+      if (text.empty())
+        return true;
+      content_->insert(cursor_position(), text);
+      cursor_position() += text.size();
+      option_->on_change();
+      return true;
+    }
+
     // Content
     if (event.is_character()) {
       content_->insert(cursor_position(), 1, to_wstring(event.character())[0]);
@@ -155,14 +172,14 @@ class WideInputBase : public ComponentBase {
   }
 
  private:
-  bool OnMouseEvent(Event event) {
+  bool OnMouseEvent(const Event& event) {
     hovered_ =
         box_.Contain(event.mouse().x, event.mouse().y) && CaptureMouse(event);
     if (!hovered_)
       return false;
 
     if (event.mouse().button != Mouse::Left ||
-        event.mouse().motion != Mouse::Pressed) {
+        event.mouse().motion == Mouse::Released) {
       return false;
     }
 
@@ -210,7 +227,7 @@ class InputBase : public WideInputBase {
     return WideInputBase::Render();
   }
 
-  bool OnEvent(Event event) override {
+  bool OnEvent(const Event& event) override {
     wrapped_content_ = to_wstring(*content_);
     if (WideInputBase::OnEvent(event)) {
       *content_ = to_string(wrapped_content_);
@@ -226,6 +226,30 @@ TEST(InputTest, Backspace) {
   EXPECT_EQ(option.cursor_position(), 0u);
 }
 
+TEST(InputTest, Paste) {
+  std::string content;
+  std::string placeholder;
+  auto option = InputOption();
+  option.cursor_position = 0;
+  Component input = Input(&content, &placeholder, &option);
+
+  input->OnEvent(Event::Character('a'));
+  input->OnEvent(Event::Character('b'));
+  input->OnEvent(Event::ArrowLeft);
+
+  // The line breaks are dropped.
+  input->OnEvent(Event::Paste("12\r\n3€"));
+  EXPECT_EQ(content, "a123€b");
+  EXPECT_EQ(option.cursor_position(), 5);
+
+  // Large pastes are inserted at once.
+  content.clear();
+  option.cursor_position() = 0;
+  input->OnEvent(Event::Paste(std::string(1'000'000, 'x')));
+  EXPECT_EQ(content.size(), 1'000'000u);
+  EXPECT_EQ(option.cursor_position(), 1'000'000);
+}
+
 // Copyright 2021 Arthur Sonzogni. All rights reserved.
 // Use of this source code is governed by the MIT license that can be found in
 // the LICENSE file.
@@ -0,0 +1,170 @@
+#include <chrono>         // for steady_clock
+#include <functional>     // for function
+#include <memory>         // for unique_ptr, shared_ptr, weak_ptr
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for move
+#include <vector>         // for vector
+
+#include "ftxui/component/component.hpp"       // for Make, Keymap
+#include "ftxui/component/component_base.hpp"  // for ComponentBase
+#include "ftxui/component/component_options.hpp"  // for KeyBinding, KeymapOption
+#include "ftxui/component/event.hpp"               // for Event
+#include "ftxui/component/screen_interactive.hpp"  // for ScreenInteractive
+#include "ftxui/component/task.hpp"                // for TimerId
+
+namespace ftxui {
+
+namespace {
+
+// A trie of key sequences. Looking up a key costs one hash, whatever the
+// number of bindings.
+struct KeyNode {
+  std::unordered_map<Event, std::unique_ptr<KeyNode>, Event::Hash> children;
+  std::function<void()> action;
+};
+
+// The progress of the user in the trie. It is shared with the timer resolving
+// an ambiguous sequence, which may outlive the component.
+struct Chord {
+  KeyNode root;
+  KeyNode* node = &root;
+  std::chrono::steady_clock::time_point last_key;
+
+  ScreenInteractive* screen = nullptr;
+  TimerId timer = 0;
+
+  // Abandon the sequence typed so far. Run its action, if any.
+  void Resolve() {
+    KeyNode* pending = node;
+    node = &root;
+    if (timer) {
+      screen->ClearTimer(timer);
+      timer = 0;
+    }
+    if (pending->action)
+      pending->action();
+  }
+};
+
+class KeymapBase : public ComponentBase {
+ public:
+  KeymapBase(std::vector<KeyBinding> bindings, Ref<KeymapOption> option)
+      : chord_(std::make_shared<Chord>()), option_(std::move(option)) {
+    for (KeyBinding& binding : bindings) {
+      KeyNode* node = &chord_->root;
+      for (const Event& key : binding.keys) {
+        auto& child = node->children[key];
+        if (!child)
+          child = std::make_unique<KeyNode>();
+        node = child.get();
+      }
+      if (node != &chord_->root)
+        node->action = std::move(binding.action);
+    }
+  }
+
+  bool OnEvent(const Event& event) override {
+    if (event.is_mouse() || event.is_cursor_reporting() || event.is_paste() ||
+        event == Event::Custom) {
+      return ComponentBase::OnEvent(event);
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (chord_->node != &chord_->root &&
+        now - chord_->last_key > option_->timeout) {
+      chord_->Resolve();
+    }
+    chord_->last_key = now;
+
+    if (Dispatch(event))
+      return true;
+    return ComponentBase::OnEvent(event);
+  }
+
+ private:
+  bool Dispatch(const Event& event) {
+    auto it = chord_->node->children.find(event);
+    if (it == chord_->node->children.end()) {
+      if (chord_->node == &chord_->root)
+        return false;
+      // The sequence typed so far is complete. Its keys are not replayed.
+      chord_->Resolve();
+      return Dispatch(event);
+    }
+
+    KeyNode* next = it->second.get();
+    if (chord_->timer) {
+      chord_->screen->ClearTimer(chord_->timer);
+      chord_->timer = 0;
+    }
+
+    if (next->children.empty()) {
+      chord_->node = &chord_->root;
+      if (next->action)
+        next->action();
+      return true;
+    }
+
+    // Wait for the next key. When the sequence typed so far is bound too, it
+    // runs once the timeout expires.
+    chord_->node = next;
+    if (next->action && event.screen_) {
+      chord_->screen = event.screen_;
+      chord_->timer = chord_->screen->SetTimeout(
+          [weak = std::weak_ptr<Chord>(chord_)] {
+            if (auto chord = weak.lock()) {
+              chord->timer = 0;
+              chord->Resolve();
+            }
+          },
+          option_->timeout);
+    }
+    return true;
+  }
+
+  std::shared_ptr<Chord> chord_;
+  Ref<KeymapOption> option_;
+};
+
+}  // namespace
+
+/// @brief Bind sequences of keys to actions, before the events reach |child|.
+/// @param child The wrapped component.
+/// @param bindings The sequences of keys, and their actions.
+/// @param option Additional optional parameters.
+/// @ingroup component
+///
+/// A sequence can have several keys, like `g g` or `Ctrl-x Ctrl-s`. Its keys
+/// must be pressed within `option.timeout` of each other. When a sequence is
+/// also the beginning of a longer one, its action runs once the next key
+/// doesn't continue it, or when the timeout expires.
+///
+/// Like any component, the keymap only receives the keys while it contains
+/// the focused component. Nested keymaps are thus scoped to their subtree.
+/// The keys not bound are forwarded to |child|.
+///
+/// Looking up a key doesn't depend on the number of bindings.
+///
+/// ### Example
+///
+/// ```cpp
+/// auto screen = ScreenInteractive::FitComponent();
+/// auto component = Keymap(Input(&text, "text"), {
+///   {{Event::Special("\x18"), Event::Special("\x13")}, [&] { Save(); }},
+///   {{Event::F1}, [&] { ShowHelp(); }},
+/// });
+/// screen.Loop(component);
+/// ```
+Component Keymap(Component child,
+                 std::vector<KeyBinding> bindings,
+                 Ref<KeymapOption> option) {
+  auto out = Make<KeymapBase>(std::move(bindings), std::move(option));
+  out->Add(std::move(child));
+  return out;
+}
+
+}  // namespace ftxui
+
+// Copyright 2021 Arthur Sonzogni. All rights reserved.
+// Use of this source code is governed by the MIT license that can be found in
+// the LICENSE file.
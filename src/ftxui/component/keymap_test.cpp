@@ -0,0 +1,137 @@
+#include <gtest/gtest-message.h>  // for Message
+#include <gtest/gtest-test-part.h>  // for TestPartResult, SuiteApiResolver, TestFactoryImpl
+#include <chrono>                   // for milliseconds
+#include <string>                   // for string, to_string
+#include <thread>                   // for sleep_for
+#include <vector>                   // for vector
+
+#include "ftxui/component/component.hpp"       // for CatchEvent, Keymap, Renderer
+#include "ftxui/component/component_base.hpp"  // for ComponentBase
+#include "ftxui/component/component_options.hpp"  // for KeyBinding, KeymapOption
+#include "ftxui/component/event.hpp"  // for Event, Event::Character, Event::Return
+#include "gtest/gtest_pred_impl.h"  // for AssertionResult, EXPECT_EQ, Test, EXPECT_TRUE, EXPECT_FALSE, TEST
+
+using namespace ftxui;
+
+namespace {
+
+// A component recording the keys it receives.
+Component Recorder(std::string* received) {
+  return CatchEvent(Renderer([] { return text(""); }),
+                    [received](const Event& event) {
+                      *received += event.character();
+                      return true;
+                    });
+}
+
+}  // namespace
+
+TEST(KeymapTest, SingleKey) {
+  std::string output;
+  std::string received;
+  auto keymap = Keymap(Recorder(&received), {
+                                                {{Event::Character('a')},
+                                                 [&] { output += "A"; }},
+                                                {{Event::Return},
+                                                 [&] { output += "R"; }},
+                                            });
+
+  EXPECT_TRUE(keymap->OnEvent(Event::Character('a')));
+  EXPECT_TRUE(keymap->OnEvent(Event::Character('b')));
+  EXPECT_TRUE(keymap->OnEvent(Event::Return));
+  EXPECT_EQ(output, "AR");
+  EXPECT_EQ(received, "b");
+}
+
+TEST(KeymapTest, Chord) {
+  std::string output;
+  std::string received;
+  const Event g = Event::Character('g');
+  auto keymap = Keymap(Recorder(&received), {
+                                                {{g, g}, [&] { output += "G"; }},
+                                            });
+
+  keymap->OnEvent(g);
+  EXPECT_EQ(output, "");
+  keymap->OnEvent(g);
+  EXPECT_EQ(output, "G");
+
+  // The chord is interrupted. The pending key is dropped, the other one is
+  // forwarded.
+  keymap->OnEvent(g);
+  keymap->OnEvent(Event::Character('x'));
+  EXPECT_EQ(output, "G");
+  EXPECT_EQ(received, "x");
+
+  // The chord restarts with the interrupting key.
+  keymap->OnEvent(g);
+  keymap->OnEvent(g);
+  keymap->OnEvent(g);
+  EXPECT_EQ(output, "GG");
+}
+
+TEST(KeymapTest, Prefix) {
+  std::string output;
+  std::string received;
+  const Event g = Event::Character('g');
+  auto keymap = Keymap(Recorder(&received), {
+                                                {{g}, [&] { output += "g"; }},
+                                                {{g, g}, [&] { output += "G"; }},
+                                            });
+
+  keymap->OnEvent(g);
+  keymap->OnEvent(g);
+  EXPECT_EQ(output, "G");
+
+  // The shorter sequence runs once the next key doesn't continue it.
+  keymap->OnEvent(g);
+  EXPECT_EQ(output, "G");
+  keymap->OnEvent(Event::Character('x'));
+  EXPECT_EQ(output, "Gg");
+  EXPECT_EQ(received, "x");
+}
+
+TEST(KeymapTest, Timeout) {
+  std::string output;
+  std::string received;
+  const Event g = Event::Character('g');
+  KeymapOption option;
+  option.timeout = std::chrono::milliseconds(1);
+  auto keymap = Keymap(Recorder(&received),
+                       {
+                           {{g, g}, [&] { output += "G"; }},
+                       },
+                       option);
+
+  keymap->OnEvent(g);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  keymap->OnEvent(g);
+  EXPECT_EQ(output, "");
+  keymap->OnEvent(g);
+  EXPECT_EQ(output, "G");
+}
+
+TEST(KeymapTest, ManyBindings) {
+  std::vector<KeyBinding> bindings;
+  std::string output;
+  const Event control_x = Event::Special("\x18");
+  for (char c = 'a'; c <= 'z'; ++c) {
+    bindings.push_back({{Event::Character(c)}, [&, c] { output += c; }});
+    bindings.push_back(
+        {{control_x, Event::Character(c)}, [&, c] { output += char(c - 32); }});
+  }
+
+  std::string received;
+  auto keymap = Keymap(Recorder(&received), std::move(bindings));
+  keymap->OnEvent(Event::Character('a'));
+  keymap->OnEvent(control_x);
+  keymap->OnEvent(Event::Character('s'));
+  keymap->OnEvent(Event::Character('z'));
+  keymap->OnEvent(Event::Character('1'));
+  EXPECT_EQ(output, "aSz");
+  EXPECT_EQ(received, "1");
+}
+
+// Copyright 2021 Arthur Sonzogni. All rights reserved.
+// Use of this source code is governed by the MIT license that can be found in
+// the LICENSE file.
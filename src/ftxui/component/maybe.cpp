@@ -21,7 +21,7 @@ Component Maybe(Component child, bool* show) {
     bool Focusable() const override {
       return *show_ && ComponentBase::Focusable();
     }
-    bool OnEvent(Event event) override {
+    bool OnEvent(const Event& event) override {
       return *show_ && ComponentBase::OnEvent(event);
     }
 
@@ -1,5 +1,5 @@
 #include <stddef.h>    // for size_t
-#include <algorithm>   // for max, min
+#include <algorithm>   // for max, min, partition_point
 #include <functional>  // for function
 #include <memory>      // for shared_ptr, allocator_traits<>::value_type
 #include <string>      // for operator+, string
@@ -48,7 +48,7 @@ class MenuBase : public ComponentBase {
     return vbox(std::move(elements)) | reflect(box_);
   }
 
-  bool OnEvent(Event event) override {
+  bool OnEvent(const Event& event) override {
     if (!CaptureMouse(event))
       return false;
 
@@ -91,7 +91,7 @@ class MenuBase : public ComponentBase {
     return false;
   }
 
-  bool OnMouseEvent(Event event) {
+  bool OnMouseEvent(const Event& event) {
     if (event.mouse().button == Mouse::WheelDown ||
         event.mouse().button == Mouse::WheelUp) {
       return OnMouseWheel(event);
@@ -103,25 +103,30 @@ class MenuBase : public ComponentBase {
     }
     if (!CaptureMouse(event))
       return false;
-    for (int i = 0; i < int(boxes_.size()); ++i) {
-      if (!boxes_[i].Contain(event.mouse().x, event.mouse().y))
-        continue;
 
-      TakeFocus();
-      focused_entry() = i;
-      if (event.mouse().button == Mouse::Left &&
-          event.mouse().motion == Mouse::Released) {
-        if (*selected_ != i) {
-          *selected_ = i;
-          option_->on_change();
-        }
-        return true;
+    // The entries are stacked vertically. The one under the mouse is found by
+    // bisection.
+    const int y = event.mouse().y;
+    auto it = std::partition_point(boxes_.begin(), boxes_.end(),
+                                   [y](const Box& box) { return box.y_max < y; });
+    if (it == boxes_.end() || !it->Contain(event.mouse().x, y))
+      return false;
+    const int i = it - boxes_.begin();
+
+    TakeFocus();
+    focused_entry() = i;
+    if (event.mouse().button == Mouse::Left &&
+        event.mouse().motion == Mouse::Released) {
+      if (*selected_ != i) {
+        *selected_ = i;
+        option_->on_change();
       }
+      return true;
     }
     return false;
   }
 
-  bool OnMouseWheel(Event event) {
+  bool OnMouseWheel(const Event& event) {
     if (!box_.Contain(event.mouse().x, event.mouse().y))
       return false;
     int old_selected = *selected_;
@@ -203,7 +208,7 @@ Component MenuEntry(ConstStringRef label, Ref<MenuEntryOption> option) {
       return text(label) | style | focus_management | reflect(box_);
     }
     bool Focusable() const override { return true; }
-    bool OnEvent(Event event) override {
+    bool OnEvent(const Event& event) override {
       if (!event.is_mouse())
         return false;
 
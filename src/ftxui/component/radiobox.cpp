@@ -1,5 +1,5 @@
 #include <stddef.h>    // for size_t
-#include <algorithm>   // for max, min
+#include <algorithm>   // for max, min, partition_point
 #include <functional>  // for function
 #include <memory>      // for shared_ptr, allocator_traits<>::value_type
 #include <string>      // for string
@@ -66,7 +66,7 @@ class RadioboxBase : public ComponentBase {
     return vbox(std::move(elements)) | reflect(box_);
   }
 
-  bool OnEvent(Event event) override {
+  bool OnEvent(const Event& event) override {
     if (!CaptureMouse(event))
       return false;
 
@@ -110,32 +110,35 @@ class RadioboxBase : public ComponentBase {
     return false;
   }
 
-  bool OnMouseEvent(Event event) {
+  bool OnMouseEvent(const Event& event) {
     if (event.mouse().button == Mouse::WheelDown ||
         event.mouse().button == Mouse::WheelUp) {
       return OnMouseWheel(event);
     }
 
-    for (int i = 0; i < int(boxes_.size()); ++i) {
-      if (!boxes_[i].Contain(event.mouse().x, event.mouse().y))
-        continue;
-
-      TakeFocus();
-      focused_entry() = i;
-      if (event.mouse().button == Mouse::Left &&
-          event.mouse().motion == Mouse::Released) {
-        if (*selected_ != i) {
-          *selected_ = i;
-          option_->on_change();
-        }
-
-        return true;
+    // One entry per row, from top to bottom: bisect on their bottom edge.
+    const int y = event.mouse().y;
+    auto it = std::partition_point(boxes_.begin(), boxes_.end(),
+                                   [y](const Box& box) { return box.y_max < y; });
+    if (it == boxes_.end() || !it->Contain(event.mouse().x, y))
+      return false;
+    const int i = it - boxes_.begin();
+
+    TakeFocus();
+    focused_entry() = i;
+    if (event.mouse().button == Mouse::Left &&
+        event.mouse().motion == Mouse::Released) {
+      if (*selected_ != i) {
+        *selected_ = i;
+        option_->on_change();
       }
+
+      return true;
     }
     return false;
   }
 
-  bool OnMouseWheel(Event event) {
+  bool OnMouseWheel(const Event& event) {
     if (!box_.Contain(event.mouse().x, event.mouse().y))
       return false;
 
@@ -2,6 +2,7 @@
 #include <gtest/gtest-test-part.h>  // for TestPartResult
 #include <thread>                   // for thread
 #include <utility>                  // for move
+#include <vector>                   // for vector
 
 #include "ftxui/component/receiver.hpp"
 #include "gtest/gtest_pred_impl.h"  // for AssertionResult, Test, EXPECT_EQ
@@ -75,6 +76,139 @@ TEST(Receiver, BasicWithThread) {
   t23.join();
 }
 
+TEST(Receiver, ReceiveAll) {
+  auto receiver = MakeReceiver<char>();
+  auto sender = receiver->MakeSender();
+
+  sender->Send('a');
+  sender->Send('b');
+  std::vector<char> items;
+  EXPECT_TRUE(receiver->ReceiveAll(&items));
+  EXPECT_EQ(items, std::vector<char>({'a', 'b'}));
+  EXPECT_FALSE(receiver->HasPending());
+
+  sender->Send('c');
+  sender.reset();
+  EXPECT_TRUE(receiver->ReceiveAll(&items));
+  EXPECT_EQ(items, std::vector<char>({'a', 'b', 'c'}));
+  EXPECT_FALSE(receiver->ReceiveAll(&items));
+}
+
+TEST(Receiver, Grow) {
+  auto receiver = MakeReceiver<int>(4);
+  auto sender = receiver->MakeSender();
+
+  // The receiving thread can send more items than the capacity.
+  for (int item = 0; item < 100; ++item)
+    sender->Send(item);
+  int item;
+  EXPECT_TRUE(receiver->Receive(&item));
+  EXPECT_EQ(item, 0);
+  for (int i = 100; i < 200; ++i)
+    sender->Send(i);
+  sender.reset();
+
+  std::vector<int> items;
+  EXPECT_TRUE(receiver->ReceiveAll(&items));
+  ASSERT_EQ(items.size(), 199u);
+  for (int i = 0; i < 199; ++i)
+    EXPECT_EQ(items[i], i + 1);
+}
+
+TEST(Receiver, DropOldest) {
+  auto receiver = MakeReceiver<char>(4, OverflowPolicy::DropOldest);
+  auto sender = receiver->MakeSender();
+  for (char c : {'a', 'b', 'c', 'd', 'e', 'f'})
+    sender->Send(c);
+  sender.reset();
+
+  std::vector<char> items;
+  EXPECT_TRUE(receiver->ReceiveAll(&items));
+  EXPECT_EQ(items, std::vector<char>({'c', 'd', 'e', 'f'}));
+}
+
+TEST(Receiver, DropNewest) {
+  auto receiver = MakeReceiver<char>(4, OverflowPolicy::DropNewest);
+  auto sender = receiver->MakeSender();
+  for (char c : {'a', 'b', 'c', 'd', 'e', 'f'})
+    sender->Send(c);
+  sender.reset();
+
+  std::vector<char> items;
+  EXPECT_TRUE(receiver->ReceiveAll(&items));
+  EXPECT_EQ(items, std::vector<char>({'a', 'b', 'c', 'd'}));
+}
+
+TEST(Receiver, BlockManyProducers) {
+  auto receiver = MakeReceiver<int>(4, OverflowPolicy::Block);
+
+  // Every producer sends more items than the capacity.
+  const int kProducers = 4;
+  const int kItems = 1000;
+  std::vector<std::thread> producers;
+  for (int i = 0; i < kProducers; ++i) {
+    producers.emplace_back(
+        [](Sender<int> sender) {
+          for (int item = 1; item <= kItems; ++item)
+            sender->Send(item);
+        },
+        receiver->MakeSender());
+  }
+
+  // Nothing is dropped.
+  int count = 0;
+  int sum = 0;
+  int item;
+  while (receiver->Receive(&item)) {
+    count++;
+    sum += item;
+  }
+  EXPECT_EQ(count, kProducers * kItems);
+  EXPECT_EQ(sum, kProducers * kItems * (kItems + 1) / 2);
+
+  for (auto& producer : producers)
+    producer.join();
+}
+
+TEST(Receiver, Lanes) {
+  auto receiver = MakeReceiver<char>(16, OverflowPolicy::Block, 2);
+  auto low = receiver->MakeSender(1);
+  auto high = receiver->MakeSender(0);
+
+  low->Send('a');
+  high->Send('b');
+  low->Send('c');
+  high->Send('d');
+
+  char c;
+  EXPECT_TRUE(receiver->Receive(&c));
+  EXPECT_EQ(c, 'b');
+
+  std::vector<char> items;
+  EXPECT_TRUE(receiver->ReceiveAll(&items));
+  EXPECT_EQ(items, std::vector<char>({'d'}));
+  items.clear();
+  EXPECT_TRUE(receiver->ReceiveAll(&items));
+  EXPECT_EQ(items, std::vector<char>({'a', 'c'}));
+}
+
+TEST(Receiver, StarvationLimit) {
+  auto receiver = MakeReceiver<char>(16, OverflowPolicy::Block, 2);
+  receiver->SetStarvationLimit(2);
+  auto low = receiver->MakeSender(1);
+  auto high = receiver->MakeSender(0);
+
+  // The low priority lane is skipped twice, then taken along the high one.
+  low->Send('a');
+  std::vector<char> items;
+  for (int i = 0; i < 3; ++i) {
+    high->Send('b');
+    items.clear();
+    EXPECT_TRUE(receiver->ReceiveAll(&items));
+  }
+  EXPECT_EQ(items, std::vector<char>({'b', 'a'}));
+}
+
 // Copyright 2020 Arthur Sonzogni. All rights reserved.
 // Use of this source code is governed by the MIT license that can be found in
 // the LICENSE file.
@@ -22,13 +22,13 @@ class ResizableSplitLeftBase : public ComponentBase {
     }));
   }
 
-  bool OnEvent(Event event) final {
+  bool OnEvent(const Event& event) final {
     if (event.is_mouse())
-      return OnMouseEvent(std::move(event));
-    return ComponentBase::OnEvent(std::move(event));
+      return OnMouseEvent(event);
+    return ComponentBase::OnEvent(event);
   }
 
-  bool OnMouseEvent(Event event) {
+  bool OnMouseEvent(const Event& event) {
     if (captured_mouse_ && event.mouse().motion == Mouse::Released) {
       captured_mouse_.reset();
       return true;
@@ -78,13 +78,13 @@ class ResizableSplitRightBase : public ComponentBase {
     }));
   }
 
-  bool OnEvent(Event event) final {
+  bool OnEvent(const Event& event) final {
     if (event.is_mouse())
-      return OnMouseEvent(std::move(event));
-    return ComponentBase::OnEvent(std::move(event));
+      return OnMouseEvent(event);
+    return ComponentBase::OnEvent(event);
   }
 
-  bool OnMouseEvent(Event event) {
+  bool OnMouseEvent(const Event& event) {
     if (captured_mouse_ && event.mouse().motion == Mouse::Released) {
       captured_mouse_.reset();
       return true;
@@ -134,13 +134,13 @@ class ResizableSplitTopBase : public ComponentBase {
     }));
   }
 
-  bool OnEvent(Event event) final {
+  bool OnEvent(const Event& event) final {
     if (event.is_mouse())
-      return OnMouseEvent(std::move(event));
-    return ComponentBase::OnEvent(std::move(event));
+      return OnMouseEvent(event);
+    return ComponentBase::OnEvent(event);
   }
 
-  bool OnMouseEvent(Event event) {
+  bool OnMouseEvent(const Event& event) {
     if (captured_mouse_ && event.mouse().motion == Mouse::Released) {
       captured_mouse_.reset();
       return true;
@@ -190,13 +190,13 @@ class ResizableSplitBottomBase : public ComponentBase {
     }));
   }
 
-  bool OnEvent(Event event) final {
+  bool OnEvent(const Event& event) final {
     if (event.is_mouse())
-      return OnMouseEvent(std::move(event));
-    return ComponentBase::OnEvent(std::move(event));
+      return OnMouseEvent(event);
+    return ComponentBase::OnEvent(event);
   }
 
-  bool OnMouseEvent(Event event) {
+  bool OnMouseEvent(const Event& event) {
     if (captured_mouse_ && event.mouse().motion == Mouse::Released) {
       captured_mouse_.reset();
       return true;
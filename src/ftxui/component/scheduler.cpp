@@ -0,0 +1,141 @@
+#include "ftxui/component/scheduler.hpp"
+
+#include <algorithm>  // for max, min
+#include <utility>    // for move, swap
+#include <vector>     // for vector
+
+namespace ftxui {
+
+Scheduler::Scheduler(Clock clock) : clock_(std::move(clock)) {}
+
+TimerId Scheduler::SetTimeout(Closure closure, Duration delay) {
+  const TimerId id = next_id_++;
+  const TimePoint deadline = Now() + delay;
+  timers_[id] = {std::move(closure), Duration::zero(), deadline};
+  queue_.emplace(deadline, id);
+  return id;
+}
+
+TimerId Scheduler::SetInterval(Closure closure, Duration period) {
+  // A zero period would run the timer forever, without ever sleeping.
+  period = std::max(period, Duration(1));
+  const TimerId id = next_id_++;
+  const TimePoint deadline = Now() + period;
+  timers_[id] = {std::move(closure), period, deadline};
+  queue_.emplace(deadline, id);
+  return id;
+}
+
+void Scheduler::ClearTimer(TimerId id) {
+  timers_.erase(id);
+
+  // The queue is rebuilt once mostly made of cleared timers.
+  if (queue_.size() > 2 * timers_.size() + 16) {
+    std::vector<Entry> entries;
+    entries.reserve(timers_.size());
+    for (const auto& it : timers_)
+      entries.emplace_back(it.second.deadline, it.first);
+    queue_ = decltype(queue_)(std::greater<Entry>(), std::move(entries));
+  }
+  DropStaleEntries();
+}
+
+bool Scheduler::IsStale(const Entry& entry) const {
+  auto it = timers_.find(entry.second);
+  return it == timers_.end() || it->second.deadline != entry.first;
+}
+
+void Scheduler::DropStaleEntries() {
+  while (!queue_.empty() && IsStale(queue_.top()))
+    queue_.pop();
+}
+
+void Scheduler::RequestAnimationFrame(Closure closure) {
+  animation_frame_callbacks_.push_back(std::move(closure));
+}
+
+void Scheduler::RequestIdleCallback(Closure closure) {
+  idle_callbacks_.push_back(std::move(closure));
+}
+
+Scheduler::TimePoint Scheduler::NextDeadline() const {
+  if (!idle_callbacks_.empty())
+    return Now();
+
+  TimePoint deadline = TimePoint::max();
+  if (!queue_.empty())
+    deadline = queue_.top().first;
+  if (!animation_frame_callbacks_.empty()) {
+    deadline =
+        std::min(deadline, last_animation_frame_ + animation_frame_period_);
+  }
+  return deadline;
+}
+
+bool Scheduler::RunTimers() {
+  const TimePoint now = Now();
+
+  // A timeout set without delay by a closure would otherwise be due in this
+  // same call, forever with a clock not moving.
+  std::vector<Entry> due;
+  while (!queue_.empty() && queue_.top().first <= now) {
+    due.push_back(queue_.top());
+    queue_.pop();
+  }
+
+  bool ran = false;
+  for (const Entry& entry : due) {
+    if (IsStale(entry))
+      continue;
+    auto it = timers_.find(entry.second);
+
+    // The closure may set or clear timers, invalidating |it|.
+    Closure closure = it->second.closure;
+    if (it->second.period == Duration::zero()) {
+      timers_.erase(it);
+    } else {
+      // A late interval is not run several times to catch up.
+      Timer& timer = it->second;
+      timer.deadline += timer.period;
+      if (timer.deadline <= now)
+        timer.deadline = now + timer.period;
+      queue_.emplace(timer.deadline, entry.second);
+    }
+    closure();
+    ran = true;
+  }
+  DropStaleEntries();
+  return ran;
+}
+
+bool Scheduler::RunAnimationFrames() {
+  if (animation_frame_callbacks_.empty())
+    return false;
+  const TimePoint now = Now();
+  if (now < last_animation_frame_ + animation_frame_period_)
+    return false;
+  last_animation_frame_ = now;
+
+  // The callbacks requested while running are for the next frame.
+  std::vector<Closure> callbacks;
+  std::swap(callbacks, animation_frame_callbacks_);
+  for (Closure& callback : callbacks)
+    callback();
+  return true;
+}
+
+bool Scheduler::RunIdleCallbacks() {
+  if (idle_callbacks_.empty())
+    return false;
+  std::vector<Closure> callbacks;
+  std::swap(callbacks, idle_callbacks_);
+  for (Closure& callback : callbacks)
+    callback();
+  return true;
+}
+
+}  // namespace ftxui
+
+// Copyright 2021 Arthur Sonzogni. All rights reserved.
+// Use of this source code is governed by the MIT license that can be found in
+// the LICENSE file.
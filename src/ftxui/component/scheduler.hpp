@@ -0,0 +1,84 @@
+#ifndef FTXUI_COMPONENT_SCHEDULER
+#define FTXUI_COMPONENT_SCHEDULER
+
+#include <chrono>         // for steady_clock
+#include <functional>     // for function, greater
+#include <queue>          // for priority_queue
+#include <unordered_map>  // for unordered_map
+#include <utility>        // for pair
+#include <vector>         // for vector
+
+#include "ftxui/component/task.hpp"  // for Closure, TimerId
+
+namespace ftxui {
+
+// The timers, animation frames and idle callbacks of a loop. The loop sleeps
+// until NextDeadline(), then calls the Run*() functions. Time is read from
+// |clock|, which can be replaced by a virtual one in tests.
+class Scheduler {
+ public:
+  using TimePoint = std::chrono::steady_clock::time_point;
+  using Duration = std::chrono::steady_clock::duration;
+  using Clock = std::function<TimePoint()>;
+
+  Scheduler(Clock clock = &std::chrono::steady_clock::now);
+
+  TimerId SetTimeout(Closure closure, Duration delay);
+  TimerId SetInterval(Closure closure, Duration period);
+  void ClearTimer(TimerId id);
+
+  // Run |closure| before drawing the next frame. Frames requested this way
+  // are separated by at least |animation_frame_period|.
+  void RequestAnimationFrame(Closure closure);
+  void SetAnimationFramePeriod(Duration period) {
+    animation_frame_period_ = period;
+  }
+
+  // Run |closure| once nothing else is pending.
+  void RequestIdleCallback(Closure closure);
+
+  // The time at which the next timer or animation frame is due, or
+  // TimePoint::max() when there are none. Now() when idle callbacks are
+  // pending.
+  TimePoint NextDeadline() const;
+
+  // Each returns whether a closure was run. Only the timers due when
+  // RunTimers() is called are run, not the ones their closures set.
+  bool RunTimers();
+  bool RunAnimationFrames();
+  bool RunIdleCallbacks();
+
+  TimePoint Now() const { return clock_(); }
+
+ private:
+  struct Timer {
+    Closure closure;
+    Duration period;  // Zero for timeouts.
+    TimePoint deadline;
+  };
+
+  Clock clock_;
+  TimerId next_id_ = 1;
+  std::unordered_map<TimerId, Timer> timers_;
+  // The deadlines, by increasing order. Entries of cleared or rescheduled
+  // timers are skipped when popped. The top one is never stale, so that
+  // NextDeadline() doesn't wake the loop for nothing.
+  using Entry = std::pair<TimePoint, TimerId>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue_;
+  bool IsStale(const Entry& entry) const;
+  void DropStaleEntries();
+
+  std::vector<Closure> animation_frame_callbacks_;
+  Duration animation_frame_period_ = std::chrono::milliseconds(16);
+  TimePoint last_animation_frame_;
+
+  std::vector<Closure> idle_callbacks_;
+};
+
+}  // namespace ftxui
+
+#endif /* end of include guard: FTXUI_COMPONENT_SCHEDULER */
+
+// Copyright 2021 Arthur Sonzogni. All rights reserved.
+// Use of this source code is governed by the MIT license that can be found in
+// the LICENSE file.
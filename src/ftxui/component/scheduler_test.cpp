@@ -0,0 +1,171 @@
+#include <gtest/gtest-message.h>    // for Message
+#include <gtest/gtest-test-part.h>  // for TestPartResult
+#include <chrono>                   // for milliseconds
+#include <functional>               // for function
+#include <string>                   // for string
+
+#include "ftxui/component/scheduler.hpp"
+#include "gtest/gtest_pred_impl.h"  // for AssertionResult, Test, EXPECT_EQ
+
+using namespace ftxui;
+using namespace std::chrono_literals;
+
+namespace {
+
+// A clock only moving forward when asked to.
+class VirtualClock {
+ public:
+  Scheduler::Clock clock() {
+    return [this] { return now_; };
+  }
+  void Advance(Scheduler::Duration duration) { now_ += duration; }
+  Scheduler::TimePoint now() const { return now_; }
+
+ private:
+  Scheduler::TimePoint now_;
+};
+
+}  // namespace
+
+TEST(Scheduler, Timeout) {
+  VirtualClock clock;
+  Scheduler scheduler(clock.clock());
+  std::string output;
+  scheduler.SetTimeout([&] { output += "b"; }, 20ms);
+  scheduler.SetTimeout([&] { output += "a"; }, 10ms);
+  EXPECT_EQ(scheduler.NextDeadline(), clock.now() + 10ms);
+
+  clock.Advance(9ms);
+  EXPECT_FALSE(scheduler.RunTimers());
+  clock.Advance(1ms);
+  EXPECT_TRUE(scheduler.RunTimers());
+  EXPECT_EQ(output, "a");
+  clock.Advance(100ms);
+  EXPECT_TRUE(scheduler.RunTimers());
+  EXPECT_EQ(output, "ab");
+  EXPECT_EQ(scheduler.NextDeadline(), Scheduler::TimePoint::max());
+}
+
+TEST(Scheduler, Interval) {
+  VirtualClock clock;
+  Scheduler scheduler(clock.clock());
+  int count = 0;
+  TimerId id = scheduler.SetInterval([&] { count++; }, 10ms);
+
+  for (int i = 0; i < 5; ++i) {
+    clock.Advance(10ms);
+    scheduler.RunTimers();
+  }
+  EXPECT_EQ(count, 5);
+
+  // A late interval isn't run several times to catch up.
+  clock.Advance(35ms);
+  scheduler.RunTimers();
+  EXPECT_EQ(count, 6);
+  EXPECT_EQ(scheduler.NextDeadline(), clock.now() + 10ms);
+
+  scheduler.ClearTimer(id);
+  clock.Advance(10ms);
+  EXPECT_FALSE(scheduler.RunTimers());
+  EXPECT_EQ(count, 6);
+}
+
+TEST(Scheduler, ClearedTimersDontWake) {
+  VirtualClock clock;
+  Scheduler scheduler(clock.clock());
+  TimerId first = scheduler.SetTimeout([] {}, 10ms);
+  TimerId second = scheduler.SetTimeout([] {}, 20ms);
+  scheduler.SetTimeout([] {}, 30ms);
+
+  scheduler.ClearTimer(second);
+  scheduler.ClearTimer(first);
+  EXPECT_EQ(scheduler.NextDeadline(), clock.now() + 30ms);
+
+  // Many timers set and cleared, like a debounce.
+  for (int i = 0; i < 1000; ++i)
+    scheduler.ClearTimer(scheduler.SetTimeout([] {}, 1ms));
+  EXPECT_EQ(scheduler.NextDeadline(), clock.now() + 30ms);
+}
+
+TEST(Scheduler, ClearFromCallback) {
+  VirtualClock clock;
+  Scheduler scheduler(clock.clock());
+  int count = 0;
+  TimerId id = 0;
+  id = scheduler.SetInterval(
+      [&] {
+        count++;
+        scheduler.ClearTimer(id);
+      },
+      10ms);
+
+  clock.Advance(100ms);
+  scheduler.RunTimers();
+  clock.Advance(100ms);
+  scheduler.RunTimers();
+  EXPECT_EQ(count, 1);
+}
+
+TEST(Scheduler, AnimationFrame) {
+  VirtualClock clock;
+  Scheduler scheduler(clock.clock());
+  clock.Advance(1s);
+  int frames = 0;
+  std::function<void()> animate = [&] {
+    frames++;
+    scheduler.RequestAnimationFrame(animate);
+  };
+  scheduler.RequestAnimationFrame(animate);
+
+  EXPECT_TRUE(scheduler.RunAnimationFrames());
+  EXPECT_EQ(frames, 1);
+
+  // The next frame is requested, but not yet due.
+  EXPECT_FALSE(scheduler.RunAnimationFrames());
+  EXPECT_EQ(scheduler.NextDeadline(), clock.now() + 16ms);
+  clock.Advance(16ms);
+  EXPECT_TRUE(scheduler.RunAnimationFrames());
+  EXPECT_EQ(frames, 2);
+}
+
+TEST(Scheduler, IdleCallback) {
+  Scheduler scheduler;
+  int count = 0;
+  scheduler.RequestIdleCallback([&] { count++; });
+  EXPECT_TRUE(scheduler.RunIdleCallbacks());
+  EXPECT_FALSE(scheduler.RunIdleCallbacks());
+  EXPECT_EQ(count, 1);
+  EXPECT_EQ(scheduler.NextDeadline(), Scheduler::TimePoint::max());
+}
+
+TEST(Scheduler, IdleCallbackIsDue) {
+  VirtualClock clock;
+  Scheduler scheduler(clock.clock());
+  scheduler.SetTimeout([] {}, 10ms);
+  scheduler.RequestIdleCallback([] {});
+  EXPECT_EQ(scheduler.NextDeadline(), clock.now());
+  scheduler.RunIdleCallbacks();
+  EXPECT_EQ(scheduler.NextDeadline(), clock.now() + 10ms);
+}
+
+TEST(Scheduler, TimeoutSetByTimeout) {
+  VirtualClock clock;
+  Scheduler scheduler(clock.clock());
+  int count = 0;
+  std::function<void()> rearm = [&] {
+    count++;
+    scheduler.SetTimeout(rearm, 0ms);
+  };
+  scheduler.SetTimeout(rearm, 0ms);
+
+  // The timeout set by the closure waits for the next call.
+  EXPECT_TRUE(scheduler.RunTimers());
+  EXPECT_EQ(count, 1);
+  EXPECT_EQ(scheduler.NextDeadline(), clock.now());
+  EXPECT_TRUE(scheduler.RunTimers());
+  EXPECT_EQ(count, 2);
+}
+
+// Copyright 2021 Arthur Sonzogni. All rights reserved.
+// Use of this source code is governed by the MIT license that can be found in
+// the LICENSE file.
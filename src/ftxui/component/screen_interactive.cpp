@@ -1,18 +1,24 @@
 #include <stdio.h>    // for fileno, stdin
 #include <algorithm>  // for copy, max, min
 #include <csignal>  // for signal, SIGABRT, SIGFPE, SIGILL, SIGINT, SIGSEGV, SIGTERM, SIGWINCH
+#include <cerrno>            // for errno, EINTR
 #include <cstdlib>           // for NULL
 #include <initializer_list>  // for initializer_list
 #include <iostream>  // for cout, ostream, basic_ostream, operator<<, endl, flush
 #include <stack>     // for stack
-#include <thread>    // for thread
+#include <thread>    // for thread, sleep_for
 #include <utility>   // for move
+#include <variant>   // for get, get_if
 #include <vector>    // for vector
 
 #include "ftxui/component/captured_mouse.hpp"  // for CapturedMouse, CapturedMouseInterface
 #include "ftxui/component/component_base.hpp"  // for ComponentBase
 #include "ftxui/component/event.hpp"           // for Event
+#include "ftxui/component/event_coalescing.hpp"  // for CoalesceEvents
+#include "ftxui/component/frame_writer.hpp"    // for FrameWriter
+#include "ftxui/component/hit_map.hpp"         // for HitMap, HitTarget
 #include "ftxui/component/mouse.hpp"           // for Mouse
+#include "ftxui/component/scheduler.hpp"  // for Scheduler
 #include "ftxui/component/receiver.hpp"  // for ReceiverImpl, MakeReceiver, Sender, SenderImpl, Receiver
 #include "ftxui/component/screen_interactive.hpp"
 #include "ftxui/component/terminal_input_parser.hpp"  // for TerminalInputParser
@@ -31,9 +37,10 @@
 #error Must be compiled in UNICODE mode
 #endif
 #else
-#include <sys/select.h>  // for select, FD_ISSET, FD_SET, FD_ZERO, fd_set
+#include <fcntl.h>   // for fcntl, F_GETFL, F_SETFL, O_NONBLOCK
+#include <poll.h>    // for poll, pollfd, POLLIN, POLLOUT, POLLHUP, POLLERR, POLLNVAL
 #include <termios.h>  // for tcsetattr, termios, tcgetattr, TCSANOW, cc_t, ECHO, ICANON, VMIN, VTIME
-#include <unistd.h>  // for STDIN_FILENO, read
+#include <unistd.h>  // for STDIN_FILENO, read, write, pipe
 #endif
 
 // Quick exit is missing in standard CLang headers
@@ -45,24 +52,85 @@ namespace ftxui {
 
 namespace {
 
+// The lanes of the event queue, by decreasing priority. The user input is
+// never delayed by the events posted by other threads. Timers aren't queued,
+// the loop runs them between two batches.
+enum Lane : size_t {
+  kInputLane,
+  kPostedLane,
+  kLaneCount,
+};
+
 void Flush() {
   // Emscripten doesn't implement flush. We interpret zero as flush.
   std::cout << '\0' << std::flush;
 }
 
-constexpr int timeout_milliseconds = 20;
-constexpr int timeout_microseconds = timeout_milliseconds * 1000;
+// Send |buffer| to the terminal. On POSIX systems, this is done with a single
+// write(2) in the common case. Returns false when the terminal can't be
+// written to anymore.
+bool Write(const std::string& buffer) {
+#if defined(_WIN32) || defined(__EMSCRIPTEN__)
+  std::cout << buffer;
+  Flush();
+  return !std::cout.fail();
+#else
+  // Keep the ordering with the output sent earlier through std::cout.
+  std::cout << std::flush;
+  const char* data = buffer.data();
+  size_t size = buffer.size();
+  while (size != 0) {
+    const ssize_t written = write(STDOUT_FILENO, data, size);
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      // The output was made non blocking by someone else. Wait for room.
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        pollfd fd = {STDOUT_FILENO, POLLOUT, 0};
+        poll(&fd, 1, -1);
+        continue;
+      }
+      return false;
+    }
+    data += written;
+    size -= written;
+  }
+  return true;
+#endif
+}
+
+// The time to wait for input, before telling the parser its pending
+// characters are complete. -1 when there are none.
+int ParserTimeout(const TerminalInputParser& parser) {
+  const auto deadline = parser.Deadline();
+  if (deadline == TerminalInputParser::TimePoint::max())
+    return -1;
+  const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(
+      deadline - std::chrono::steady_clock::now());
+  return std::max(0, int(remaining.count()));
+}
+
 #if defined(_WIN32)
 
-void EventListener(std::atomic<bool>* quit, Sender<Event> out) {
+constexpr int timeout_milliseconds = 20;
+
+void WakeUpEventListener() {}
+
+void EventListener(std::atomic<bool>* quit,
+                   std::atomic<bool>* resized,
+                   std::chrono::milliseconds escape_timeout,
+                   Sender<Task> out) {
   auto console = GetStdHandle(STD_INPUT_HANDLE);
-  auto parser = TerminalInputParser(out->Clone());
+  auto parser = TerminalInputParser(out->Clone(), escape_timeout);
   while (!*quit) {
-    // Throttle ReadConsoleInput by waiting 250ms, this wait function will
+    // Throttle ReadConsoleInput by waiting 20ms, this wait function will
     // return if there is input in the console.
-    auto wait_result = WaitForSingleObject(console, timeout_milliseconds);
+    int timeout = ParserTimeout(parser);
+    if (timeout < 0 || timeout > timeout_milliseconds)
+      timeout = timeout_milliseconds;
+    auto wait_result = WaitForSingleObject(console, timeout);
     if (wait_result == WAIT_TIMEOUT) {
-      parser.Timeout(timeout_milliseconds);
+      parser.Timeout(std::chrono::steady_clock::now());
       continue;
     }
 
@@ -88,7 +156,9 @@ void EventListener(std::atomic<bool>* quit, Sender<Event> out) {
           parser.Add((char)key_event.uChar.UnicodeChar);
         } break;
         case WINDOW_BUFFER_SIZE_EVENT:
-          out->Send(Event::Special({0}));
+          // Resize storms are coalesced into a single event.
+          if (!resized->exchange(true))
+            out->Send(Event::Special({0}));
           break;
         case MENU_EVENT:
         case FOCUS_EVENT:
@@ -104,9 +174,12 @@ void EventListener(std::atomic<bool>* quit, Sender<Event> out) {
 #include <emscripten.h>
 
 // Read char from the terminal.
-void EventListener(std::atomic<bool>* quit, Sender<Event> out) {
-  (void)timeout_microseconds;
-  auto parser = TerminalInputParser(std::move(out));
+void EventListener(std::atomic<bool>* quit,
+                   std::atomic<bool>* resized,
+                   std::chrono::milliseconds escape_timeout,
+                   Sender<Task> out) {
+  (void)resized;
+  auto parser = TerminalInputParser(std::move(out), escape_timeout);
 
   char c;
   while (!*quit) {
@@ -114,38 +187,108 @@ void EventListener(std::atomic<bool>* quit, Sender<Event> out) {
       parser.Add(c);
 
     emscripten_sleep(1);
-    parser.Timeout(1);
+    parser.Timeout(std::chrono::steady_clock::now());
   }
 }
 
+void WakeUpEventListener() {}
+
 #else
-#include <sys/time.h>  // for timeval
 
-int CheckStdinReady(int usec_timeout) {
-  timeval tv = {0, usec_timeout};
-  fd_set fds;
-  FD_ZERO(&fds);
-  FD_SET(STDIN_FILENO, &fds);
-  select(STDIN_FILENO + 1, &fds, NULL, NULL, &tv);
-  return FD_ISSET(STDIN_FILENO, &fds);
+// The event listener sleeps until either the terminal or this pipe has data
+// to read. Writing to the pipe is async-signal-safe.
+int wakeup_pipe[2] = {-1, -1};
+constexpr char kWakeUpQuit = 'q';
+constexpr char kWakeUpResize = 'r';
+// Without the pipe, or after poll() failed, the listener checks whether to quit
+// this often.
+constexpr int kFallbackTimeout = 20;
+
+void CreateWakeUpPipe() {
+  if (wakeup_pipe[0] != -1)
+    return;
+  if (pipe(wakeup_pipe) != 0)
+    return;
+  for (int fd : wakeup_pipe)
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+void WakeUpEventListener(char reason) {
+  if (wakeup_pipe[1] == -1)
+    return;
+  const int saved_errno = errno;
+  (void)!write(wakeup_pipe[1], &reason, 1);
+  errno = saved_errno;
+}
+
+void WakeUpEventListener() {
+  WakeUpEventListener(kWakeUpQuit);
+}
+
+void OnResize(int /* signal */) {
+  WakeUpEventListener(kWakeUpResize);
 }
 
 // Read char from the terminal.
-void EventListener(std::atomic<bool>* quit, Sender<Event> out) {
-  const int buffer_size = 100;
+void EventListener(std::atomic<bool>* quit,
+                   std::atomic<bool>* resized,
+                   std::chrono::milliseconds escape_timeout,
+                   Sender<Task> out) {
+  const int buffer_size = 4096;
+
+  auto parser = TerminalInputParser(out->Clone(), escape_timeout);
 
-  auto parser = TerminalInputParser(std::move(out));
+  pollfd fds[2] = {
+      {STDIN_FILENO, POLLIN, 0},
+      {wakeup_pipe[0], POLLIN, 0},
+  };
 
   while (!*quit) {
-    if (!CheckStdinReady(timeout_microseconds)) {
-      parser.Timeout(timeout_milliseconds);
+    // Sleep without timeout, unless the parser waits to know whether the
+    // pending characters are complete, like an ESC key press.
+    int timeout = ParserTimeout(parser);
+    if (fds[1].fd == -1 && (timeout < 0 || timeout > kFallbackTimeout))
+      timeout = kFallbackTimeout;
+    const int ready = poll(fds, 2, timeout);
+    if (ready < 0) {
+      // Not interrupted by a signal: don't spin on the error.
+      if (errno != EINTR) {
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(kFallbackTimeout));
+      }
+      continue;
+    }
+    if (ready == 0) {
+      parser.Timeout(std::chrono::steady_clock::now());
       continue;
     }
 
-    char buff[buffer_size];
-    int l = read(fileno(stdin), buff, buffer_size);
-    for (int i = 0; i < l; ++i)
-      parser.Add(buff[i]);
+    // An invalid descriptor is reported by every poll(). Stop watching it.
+    if (fds[0].revents & POLLNVAL)
+      fds[0].fd = -1;
+    if (fds[1].revents & POLLNVAL)
+      fds[1].fd = -1;
+
+    if (fds[1].revents & POLLIN) {
+      char reasons[64];
+      const int l = read(fds[1].fd, reasons, sizeof(reasons));
+      // Resize storms are coalesced into a single event, until the screen
+      // reads the new dimensions.
+      for (int i = 0; i < l; ++i) {
+        if (reasons[i] == kWakeUpResize && !resized->exchange(true))
+          out->Send(Event::Special({0}));
+      }
+    }
+
+    if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+      char buff[buffer_size];
+      const int l = read(fds[0].fd, buff, buffer_size);
+      // Stop watching a closed or failing input.
+      if (l == 0 || (l < 0 && errno != EINTR && errno != EAGAIN))
+        fds[0].fd = -1;
+      if (l > 0)
+        parser.Add(buff, l);
+    }
   }
 }
 
@@ -165,6 +308,7 @@ enum class DECMode {
   kMouseUrxvtMode = 1015,
   kMouseSgrPixelsMode = 1016,
   kAlternateScreen = 1049,
+  kBracketedPaste = 2004,
 };
 
 // Device Status Report (DSR) {
@@ -214,10 +358,8 @@ auto install_signal_handler = [](int sig, SignalHandler handler) {
   on_exit_functions.push([&]() { std::signal(sig, old_signal_handler); });
 };
 
-std::function<void()> on_resize = [] {};
-void OnResize(int /* signal */) {
-  on_resize();
-}
+// The number of tasks handled between two checks of whether a frame is due.
+constexpr size_t kMaxTasksPerFrame = 256;
 
 class CapturedMouseImpl : public CapturedMouseInterface {
  public:
@@ -236,11 +378,19 @@ ScreenInteractive::ScreenInteractive(int dimx,
                                      bool use_alternative_screen)
     : Screen(dimx, dimy),
       dimension_(dimension),
-      use_alternative_screen_(use_alternative_screen) {
-  event_receiver_ = MakeReceiver<Event>();
-  event_sender_ = event_receiver_->MakeSender();
+      use_alternative_screen_(use_alternative_screen),
+      scheduler_(std::make_unique<Scheduler>()),
+      hit_map_(std::make_unique<HitMap>()) {
+  // The loop thread posts to itself, from the components, timers and idle
+  // callbacks. Only the input listener waits when the loop falls behind.
+  task_receiver_ = MakeReceiver<Task>(kDefaultReceiverCapacity,
+                                      OverflowPolicy::Grow, kLaneCount);
+  task_receiver_->SetOverflowPolicy(kInputLane, OverflowPolicy::Block);
+  task_sender_ = task_receiver_->MakeSender(kPostedLane);
 }
 
+ScreenInteractive::~ScreenInteractive() = default;
+
 // static
 ScreenInteractive ScreenInteractive::FixedSize(int dimx, int dimy) {
   return ScreenInteractive(dimx, dimy, Dimension::Fixed, false);
@@ -261,17 +411,68 @@ ScreenInteractive ScreenInteractive::FitComponent() {
   return ScreenInteractive(0, 0, Dimension::FitComponent, false);
 }
 
+size_t ScreenInteractive::LastFrameBytes() const {
+  return frame_writer_ ? frame_writer_->last_frame_bytes() : 0;
+}
+
 void ScreenInteractive::PostEvent(Event event) {
+  Post(std::move(event));
+}
+
+void ScreenInteractive::Post(Task task) {
   if (!quit_)
-    event_sender_->Send(event);
+    task_sender_->Send(std::move(task));
+}
+
+void ScreenInteractive::SetStarvationLimit(int batches) {
+  task_receiver_->SetStarvationLimit(batches);
+}
+
+TimerId ScreenInteractive::SetTimeout(Closure closure, Duration delay) {
+  return scheduler_->SetTimeout(std::move(closure), delay);
+}
+
+TimerId ScreenInteractive::SetInterval(Closure closure, Duration period) {
+  return scheduler_->SetInterval(std::move(closure), period);
+}
+
+void ScreenInteractive::ClearTimer(TimerId id) {
+  scheduler_->ClearTimer(id);
+}
+
+void ScreenInteractive::RequestAnimationFrame(Closure closure) {
+  scheduler_->RequestAnimationFrame(std::move(closure));
+}
+
+void ScreenInteractive::RequestIdleCallback(Closure closure) {
+  scheduler_->RequestIdleCallback(std::move(closure));
+}
+
+void ScreenInteractive::SetMaxFrameRate(int fps) {
+  frame_interval_ = fps > 0 ? Duration(std::chrono::seconds(1)) / fps
+                            : Duration::zero();
+}
+
+void ScreenInteractive::RequestRedraw() {
+  // Wake up the loop, unless a redraw is already requested.
+  if (!redraw_requested_.exchange(true))
+    Post([] {});
 }
 
 CapturedMouse ScreenInteractive::CaptureMouse() {
+  return CaptureMouse(nullptr);
+}
+
+// While |owner| holds the mouse, the mouse events are routed to it.
+CapturedMouse ScreenInteractive::CaptureMouse(ComponentBase* owner) {
   if (mouse_captured)
     return nullptr;
   mouse_captured = true;
-  return std::make_unique<CapturedMouseImpl>(
-      [this] { mouse_captured = false; });
+  mouse_owner_ = owner;
+  return std::make_unique<CapturedMouseImpl>([this] {
+    mouse_captured = false;
+    mouse_owner_ = nullptr;
+  });
 }
 
 void ScreenInteractive::Loop(Component component) {
@@ -280,7 +481,7 @@ void ScreenInteractive::Loop(Component component) {
   // Suspend previously active screen:
   if (g_active_screen) {
     std::swap(suspended_screen_, g_active_screen);
-    std::cout << suspended_screen_->reset_cursor_position
+    std::cout << suspended_screen_->frame_writer_->reset_cursor_position()
               << suspended_screen_->ResetPosition(/*clear=*/true);
     suspended_screen_->dimx_ = 0;
     suspended_screen_->dimy_ = 0;
@@ -295,7 +496,7 @@ void ScreenInteractive::Loop(Component component) {
   g_active_screen = nullptr;
 
   // Put cursor position at the end of the drawing.
-  std::cout << reset_cursor_position;
+  std::cout << frame_writer_->reset_cursor_position();
 
   // Restore suspended screen.
   if (suspended_screen_) {
@@ -366,7 +567,7 @@ void ScreenInteractive::Install() {
   tcsetattr(STDIN_FILENO, TCSANOW, &terminal);
 
   // Handle resize.
-  on_resize = [&] { event_sender_->Send(Event::Special({0})); };
+  CreateWakeUpPipe();
   install_signal_handler(SIGWINCH, OnResize);
 #endif
 
@@ -404,51 +605,259 @@ void ScreenInteractive::Install() {
       DECMode::kMouseSgrExtMode,
   });
 
+  // Pasted text is received as a single Event::Paste.
+  enable({
+      DECMode::kBracketedPaste,
+  });
+
+  // Push the "disambiguate escape codes" flag of the kitty keyboard protocol,
+  // and pop it on exit.
+  if (kitty_keyboard_protocol_) {
+    std::cout << "\x1B[>1u";
+    on_exit_functions.push([] { std::cout << "\x1B[<u"; });
+  }
+
   flush();
 
+  // The frames are sent to the terminal from a dedicated thread, starting from
+  // a blank terminal.
+  // The loop stops once the terminal can't be written to anymore. The writing
+  // thread uses its own sender, |task_sender_| belongs to the loop thread. It
+  // isn't kept: the loop exits when the last sender is released.
+  frame_writer_ =
+      std::make_unique<FrameWriter>([this](const std::string& frame) {
+        if (!Write(frame) && !quit_)
+          task_receiver_->MakeSender()->Send(ExitLoopClosure());
+      });
+
   quit_ = false;
-  event_listener_ =
-      std::thread(&EventListener, &quit_, event_receiver_->MakeSender());
+  // The terminal might have been resized while this screen wasn't installed.
+  terminal_resized_ = true;
+  event_listener_ = std::thread(&EventListener, &quit_, &terminal_resized_,
+                                escape_timeout_,
+                                task_receiver_->MakeSender(kInputLane));
 }
 
 void ScreenInteractive::Uninstall() {
   ExitLoopClosure()();
   event_listener_.join();
+  frame_writer_->Flush();
 
   OnExit(0);
 }
 
 void ScreenInteractive::Main(Component component) {
+  // The whole backlog is taken at every wakeup. It is handled by parts, so
+  // that frames keep being drawn while it doesn't drain.
+  std::vector<Task> tasks;
+  size_t next_task = 0;
+  bool dirty = true;     // Whether the displayed frame is outdated.
+  bool handled = false;  // Whether a task or a timer ran since the last frame.
+  auto next_frame = std::chrono::steady_clock::time_point();
   while (!quit_) {
-    if (!event_receiver_->HasPending()) {
+    handled |= scheduler_->RunTimers();
+    if (quit_)
+      break;
+
+    // The animation frames and the idle callbacks wait for the backlog to be
+    // handled, unless a frame is due.
+    const bool backlog =
+        next_task != tasks.size() || task_receiver_->HasPending();
+    if (!backlog || std::chrono::steady_clock::now() >= next_frame) {
+      dirty |= scheduler_->RunAnimationFrames();
+      handled |= scheduler_->RunIdleCallbacks();
+    }
+
+    // The tasks and timers may have moved the focus.
+    if (handled || dirty)
+      handled |= NotifyFocusChange(component);
+
+    dirty |= redraw_requested_.exchange(false) || terminal_resized_ ||
+             (handled && !redraw_on_demand_);
+    handled = false;
+
+    // Draw at most once per frame interval, even if the backlog isn't handled
+    // yet.
+    const auto now = std::chrono::steady_clock::now();
+    if (dirty && now >= next_frame) {
       Draw(component);
-      std::cout << ToString() << set_cursor_position;
-      Flush();
       Clear();
+      dirty = false;
+      next_frame = now + frame_interval_;
     }
 
-    Event event;
-    if (!event_receiver_->Receive(&event))
-      break;
-
-    if (event.is_cursor_reporting()) {
-      cursor_x_ = event.cursor_x();
-      cursor_y_ = event.cursor_y();
-      continue;
+    // Sleep until the next task, timer or frame.
+    if (next_task == tasks.size()) {
+      auto deadline = scheduler_->NextDeadline();
+      if (dirty)
+        deadline = std::min(deadline, next_frame);
+      tasks.clear();
+      next_task = 0;
+      if (!task_receiver_->ReceiveAllUntil(&tasks, deadline))
+        break;
+      if (event_coalescing_)
+        CoalesceEvents(&tasks);
     }
 
-    if (event.is_mouse()) {
-      event.mouse().x -= cursor_x_;
-      event.mouse().y -= cursor_y_;
+    const size_t end = std::min(tasks.size(), next_task + kMaxTasksPerFrame);
+    for (; next_task < end; ++next_task) {
+      if (quit_)
+        break;
+      Task& task = tasks[next_task];
+
+      if (auto* closure = std::get_if<Closure>(&task)) {
+        (*closure)();
+        handled = true;
+        continue;
+      }
+
+      // The cursor position is requested by Draw(). It doesn't change the
+      // frame.
+      Event& event = std::get<Event>(task);
+      if (event.is_cursor_reporting()) {
+        cursor_x_ = event.cursor_x();
+        cursor_y_ = event.cursor_y();
+        continue;
+      }
+
+      if (event.is_mouse()) {
+        event.mouse().x -= cursor_x_;
+        event.mouse().y -= cursor_y_;
+      }
+
+      event.screen_ = this;
+      if (event.is_mouse())
+        DispatchMouse(component, event);
+      else if (!component->OnEvent(event) && event.is_paste())
+        DispatchPasteAsInput(component, event);
+      handled = true;
     }
+  }
+
+  // The components lose the focus when the loop exits.
+  NotifyFocusChange(nullptr);
+}
 
+void ScreenInteractive::DispatchPasteAsInput(const Component& component,
+                                             const Event& paste) {
+  auto receiver = MakeReceiver<Task>();
+  {
+    auto parser = TerminalInputParser(receiver->MakeSender());
+    const std::string text = paste.paste();
+    parser.Add(text.data(), text.size());
+    if (parser.HasPending())
+      parser.Timeout(std::chrono::steady_clock::time_point::max());
+  }
+
+  Task task;
+  while (receiver->Receive(&task)) {
+    Event& event = std::get<Event>(task);
     event.screen_ = this;
     component->OnEvent(event);
   }
 }
 
+namespace {
+
+// The components from the root to |component|. Returns false when |root| isn't
+// an ancestor.
+bool PathTo(ComponentBase* component,
+            const ComponentBase* root,
+            std::vector<ComponentBase*>* path) {
+  path->clear();
+  for (; component; component = component->Parent())
+    path->push_back(component);
+  std::reverse(path->begin(), path->end());
+  return !path->empty() && path->front() == root;
+}
+
+}  // namespace
+
+void ScreenInteractive::DispatchMouse(const Component& component,
+                                      const Event& event) {
+  Component hovered;
+  ComponentBase* target = mouse_owner_;
+  if (!target) {
+    hovered = hit_map_->At(event.mouse().x, event.mouse().y);
+    target = hovered.get();
+  }
+
+  // Components not found in the map receive the event from their parent,
+  // which forwards it to all its children.
+  if (!PathTo(target, component.get(), &mouse_path_))
+    mouse_path_.clear();
+  component->OnEvent(event);
+
+  // Only a motion can make the mouse leave a component. The clicks, releases
+  // and wheel events are only sent to the component under the mouse.
+  if (mouse_owner_ || event.mouse().button != Mouse::None) {
+    mouse_path_.clear();
+    return;
+  }
+
+  // The component previously under the mouse learns it left, through the
+  // ancestors not shared with the new one.
+  Component previous = mouse_target_.lock();
+  mouse_target_ = hovered;
+  std::vector<ComponentBase*> path;
+  if (previous && previous != hovered &&
+      PathTo(previous.get(), component.get(), &path)) {
+    size_t i = 0;
+    while (i < path.size() && i < mouse_path_.size() &&
+           path[i] == mouse_path_[i]) {
+      ++i;
+    }
+    if (i < path.size()) {
+      mouse_path_ = std::move(path);
+      mouse_path_[i]->OnEvent(event);
+    }
+  }
+  mouse_path_.clear();
+}
+
+ComponentBase* ScreenInteractive::MouseRoute(
+    const ComponentBase* component) const {
+  for (size_t i = 0; i + 1 < mouse_path_.size(); ++i) {
+    if (mouse_path_[i] == component)
+      return mouse_path_[i + 1];
+  }
+  return nullptr;
+}
+
+bool ScreenInteractive::NotifyFocusChange(const Component& component) {
+  std::vector<Component> path;
+  for (Component it = component; it; it = it->ActiveChild())
+    path.push_back(it);
+
+  // The common ancestors keep the focus.
+  size_t common = 0;
+  while (common < path.size() && common < focus_path_.size() &&
+         focus_path_[common].lock() == path[common]) {
+    ++common;
+  }
+  if (common == path.size() && common == focus_path_.size())
+    return false;
+
+  std::vector<std::weak_ptr<ComponentBase>> previous = std::move(focus_path_);
+  focus_path_.assign(path.begin(), path.end());
+  for (size_t i = previous.size(); i-- > common;) {
+    if (Component it = previous[i].lock())
+      it->OnFocusChange(false);
+  }
+  for (size_t i = common; i < path.size(); ++i)
+    path[i]->OnFocusChange(true);
+  return true;
+}
+
 void ScreenInteractive::Draw(Component component) {
-  auto document = component->Render();
+  // Focused() is computed once per component while rendering.
+  ComponentBase::FocusCache focus_cache;
+
+  // The terminal dimensions are only queried after being resized.
+  if (terminal_resized_.exchange(false))
+    terminal_size_ = Terminal::Size();
+
+  auto document = HitTarget(component->Render(), component);
   int dimx = 0;
   int dimy = 0;
   switch (dimension_) {
@@ -458,29 +867,25 @@ void ScreenInteractive::Draw(Component component) {
       break;
     case Dimension::TerminalOutput:
       document->ComputeRequirement();
-      dimx = Terminal::Size().dimx;
+      dimx = terminal_size_.dimx;
       dimy = document->requirement().min_y;
       break;
     case Dimension::Fullscreen:
-      dimx = Terminal::Size().dimx;
-      dimy = Terminal::Size().dimy;
+      dimx = terminal_size_.dimx;
+      dimy = terminal_size_.dimy;
       break;
     case Dimension::FitComponent:
-      auto terminal = Terminal::Size();
       document->ComputeRequirement();
-      dimx = std::min(document->requirement().min_x, terminal.dimx);
-      dimy = std::min(document->requirement().min_y, terminal.dimy);
+      dimx = std::min(document->requirement().min_x, terminal_size_.dimx);
+      dimy = std::min(document->requirement().min_y, terminal_size_.dimy);
       break;
   }
 
-  bool resized = (dimx != dimx_) || (dimy != dimy_);
-  std::cout << reset_cursor_position << ResetPosition(/*clear=*/resized);
-
   // Resize the screen if needed.
-  if (resized) {
+  if ((dimx != dimx_) || (dimy != dimy_)) {
     dimx_ = dimx;
     dimy_ = dimy;
-    pixels_ = std::vector<std::vector<Pixel>>(dimy, std::vector<Pixel>(dimx));
+    pixels_.assign(dimx * dimy, Pixel());
     cursor_.x = dimx_ - 1;
     cursor_.y = dimy_ - 1;
   }
@@ -502,32 +907,29 @@ void ScreenInteractive::Draw(Component component) {
 #endif
   static int i = -3;
   ++i;
+  std::string requests;
   if (!use_alternative_screen_ && (i % cursor_refresh_rate == 0))
-    std::cout << DeviceStatusReport(DSRMode::kCursor);
+    requests = DeviceStatusReport(DSRMode::kCursor);
 
+  // Record the component drawn on each cell, to route the mouse events.
+  hit_map_->Start(dimx_, dimy_);
   Render(*this, document);
-
-  // Set cursor position for user using tools to insert CJK characters.
-  set_cursor_position = "";
-  reset_cursor_position = "";
-
-  int dx = dimx_ - 1 - cursor_.x;
-  int dy = dimy_ - 1 - cursor_.y;
-
-  if (dx != 0) {
-    set_cursor_position += "\x1B[" + std::to_string(dx) + "D";
-    reset_cursor_position += "\x1B[" + std::to_string(dx) + "C";
-  }
-  if (dy != 0) {
-    set_cursor_position += "\x1B[" + std::to_string(dy) + "A";
-    reset_cursor_position += "\x1B[" + std::to_string(dy) + "B";
-  }
+  hit_map_->Stop();
+
+  FrameWriter::Options options;
+  options.synchronized_update = synchronized_update_;
+  // A fullscreen frame drawn on the alternative screen covers the whole
+  // terminal. Its shifted rows can be moved by the terminal itself.
+  options.scroll =
+      dimension_ == Dimension::Fullscreen && use_alternative_screen_;
+  frame_writer_->Send(*this, requests, options);
 }
 
 std::function<void()> ScreenInteractive::ExitLoopClosure() {
   return [this]() {
     quit_ = true;
-    event_sender_.reset();
+    task_sender_.reset();
+    WakeUpEventListener();
   };
 }
 
@@ -1,8 +1,16 @@
 #include <gtest/gtest-message.h>  // for Message
 #include <gtest/gtest-test-part.h>  // for SuiteApiResolver, TestFactoryImpl, TestPartResult
+#include <chrono>  // for milliseconds
 #include <csignal>  // for raise, SIGABRT, SIGFPE, SIGILL, SIGINT, SIGSEGV, SIGTERM
+#include <functional>  // for function
+#include <string>   // for string
+#include <utility>  // for move
+#include <vector>   // for vector
 
-#include "ftxui/component/component.hpp"  // for Renderer
+#include "ftxui/component/component.hpp"  // for Renderer, CatchEvent, Vertical, Horizontal, Make
+#include "ftxui/component/component_base.hpp"  // for ComponentBase
+#include "ftxui/component/event.hpp"      // for Event
+#include "ftxui/component/mouse.hpp"      // for Mouse
 #include "ftxui/component/screen_interactive.hpp"
 #include "ftxui/dom/elements.hpp"   // for text, Element
 #include "gtest/gtest_pred_impl.h"  // for Test, TEST, EXPECT_EQ
@@ -47,6 +55,241 @@ TEST(ScreenInteractive, Signal_SIGFPE) {
   TestSignal(SIGFPE);
 }
 
+TEST(ScreenInteractive, Timers) {
+  using namespace std::chrono_literals;
+  int ticks = 0;
+  int drawn_ticks = 0;
+  auto screen = ScreenInteractive::FitComponent();
+  auto component = Renderer([&] {
+    drawn_ticks = ticks;
+    if (drawn_ticks >= 3)
+      screen.ExitLoopClosure()();
+    return text("");
+  });
+
+  // The ticks are drawn. The loop exits once the third one is.
+  screen.SetInterval([&] { ticks++; }, 1ms);
+  screen.SetTimeout(screen.ExitLoopClosure(), 5s);
+  screen.Loop(component);
+
+  EXPECT_GE(drawn_ticks, 3);
+}
+
+TEST(ScreenInteractive, PostFromLoop) {
+  using namespace std::chrono_literals;
+  int received = 0;
+  auto component = CatchEvent(Renderer([] { return text(""); }),
+                              [&](const Event& event) {
+                                if (event == Event::Character('a'))
+                                  received++;
+                                return true;
+                              });
+
+  // The loop posts more tasks than the queue capacity to itself.
+  auto screen = ScreenInteractive::FitComponent();
+  screen.SetTimeout(
+      [&] {
+        for (int i = 0; i < 2000; ++i)
+          screen.PostEvent(Event::Character('a'));
+        screen.Post(screen.ExitLoopClosure());
+      },
+      1ms);
+  screen.Loop(component);
+
+  EXPECT_EQ(received, 2000);
+}
+
+TEST(ScreenInteractive, UnhandledPaste) {
+  std::vector<Event> received;
+  bool handle_paste = false;
+  auto component = CatchEvent(Renderer([] { return text(""); }),
+                              [&](const Event& event) {
+                                received.push_back(event);
+                                return handle_paste && event.is_paste();
+                              });
+
+  const std::string pasted = "a€" + Event::Return.input();
+  auto screen = ScreenInteractive::FitComponent();
+  screen.Post(Event::Paste(pasted));
+  screen.Post([&] { handle_paste = true; });
+  screen.Post(Event::Paste("b"));
+  screen.Post(screen.ExitLoopClosure());
+  screen.Loop(component);
+
+  // The first paste is dispatched again as characters, not the second one.
+  const std::vector<Event> expected = {
+      Event::Paste(pasted), Event::Character('a'), Event::Character("€"),
+      Event::Return,        Event::Paste("b"),
+  };
+  EXPECT_EQ(received, expected);
+}
+
+TEST(ScreenInteractive, MaxFrameRate) {
+  using namespace std::chrono_literals;
+  int renders = 0;
+  int ticks = 0;
+  auto component = Renderer([&] {
+    renders++;
+    return text("");
+  });
+
+  // The ticks are much more frequent than the frames.
+  auto screen = ScreenInteractive::FitComponent();
+  screen.SetMaxFrameRate(20);
+  screen.SetInterval([&] { ticks++; }, 1ms);
+  screen.SetTimeout(screen.ExitLoopClosure(), 200ms);
+  screen.Loop(component);
+
+  EXPECT_GE(ticks, 20);
+  EXPECT_LE(renders, 6);
+}
+
+TEST(ScreenInteractive, DrawDuringBacklog) {
+  using namespace std::chrono_literals;
+  int renders = 0;
+  int animation_frames = 0;
+  auto screen = ScreenInteractive::FitComponent();
+  auto component = Renderer([&] {
+    if (++renders == 3)
+      screen.ExitLoopClosure()();
+    return text("");
+  });
+
+  // The backlog never drains: every task posts the next one.
+  std::function<void()> post = [&] { screen.Post(post); };
+  screen.SetTimeout(post, 1ms);
+  screen.RequestAnimationFrame([&] { animation_frames++; });
+  screen.SetTimeout(screen.ExitLoopClosure(), 5s);
+  screen.Loop(component);
+
+  EXPECT_EQ(renders, 3);
+  EXPECT_EQ(animation_frames, 1);
+}
+
+TEST(ScreenInteractive, RedrawOnDemand) {
+  using namespace std::chrono_literals;
+  int renders = 0;
+  int ticks = 0;
+  auto component = Renderer([&] {
+    renders++;
+    return text("");
+  });
+
+  auto screen = ScreenInteractive::FitComponent();
+  screen.SetRedrawOnDemand(true);
+  screen.SetInterval(
+      [&] {
+        // Only every 4th tick modifies the frame.
+        if (++ticks % 4 == 0)
+          screen.RequestRedraw();
+        if (ticks == 12)
+          screen.ExitLoopClosure()();
+      },
+      1ms);
+  screen.Loop(component);
+
+  // The first frame, and the 2 requested before exiting.
+  EXPECT_EQ(renders, 3);
+}
+
+TEST(ScreenInteractive, MouseRouting) {
+  // Three rows, counting the mouse events they receive.
+  std::vector<int> received(3, 0);
+  Components rows;
+  for (int& count : received) {
+    rows.push_back(CatchEvent(Renderer([] { return text("row"); }),
+                              [&count](const Event& event) {
+                                if (event.is_mouse())
+                                  count++;
+                                return false;
+                              }));
+  }
+  auto container = Container::Vertical(std::move(rows));
+
+  auto screen = ScreenInteractive::FixedSize(3, 3);
+  screen.SetEventCoalescing(false);
+  auto post = [&](Mouse::Button button, int y) {
+    Mouse mouse;
+    mouse.button = button;
+    mouse.motion = button == Mouse::None ? Mouse::Released : Mouse::Pressed;
+    mouse.shift = false;
+    mouse.meta = false;
+    mouse.control = false;
+    // The terminal coordinates start at 1.
+    mouse.x = 1;
+    mouse.y = y + 1;
+    screen.PostEvent(Event::Mouse("", mouse));
+  };
+
+  // The events are posted once the first frame is drawn, so that the rows
+  // are known to be under the mouse.
+  bool posted = false;
+  auto component = Renderer(container, [&] {
+    if (!posted) {
+      posted = true;
+      post(Mouse::None, 1);
+      post(Mouse::None, 2);
+      post(Mouse::Left, 0);
+      screen.Post(screen.ExitLoopClosure());
+    }
+    return container->Render();
+  });
+  screen.Loop(component);
+
+  // Only the row under the mouse receives the event. The second row also
+  // receives the motion making the mouse leave it, but the third one doesn't
+  // receive the click.
+  EXPECT_EQ(received[0], 1);
+  EXPECT_EQ(received[1], 2);
+  EXPECT_EQ(received[2], 1);
+}
+
+TEST(ScreenInteractive, FocusChange) {
+  std::vector<std::string> log;
+
+  class Recorder : public ComponentBase {
+   public:
+    Recorder(std::vector<std::string>* log, std::string name)
+        : log_(log), name_(std::move(name)) {}
+    Element Render() override { return text(name_); }
+    bool Focusable() const override { return true; }
+    void OnFocusChange(bool focused) override {
+      log_->push_back((focused ? "+" : "-") + name_);
+    }
+
+   private:
+    std::vector<std::string>* log_;
+    std::string name_;
+  };
+
+  auto a = Make<Recorder>(&log, "a");
+  auto b = Make<Recorder>(&log, "b");
+  auto container = Container::Horizontal({a, b});
+
+  // Every frame posts the next step. The focus is checked once per frame, so
+  // every step is noticed.
+  auto screen = ScreenInteractive::FixedSize(2, 1);
+  int frame = 0;
+  auto component = Renderer(container, [&] {
+    switch (frame++) {
+      case 0:
+        screen.Post([&] { b->TakeFocus(); });
+        break;
+      case 1:
+        screen.PostEvent(Event::ArrowLeft);
+        break;
+      case 2:
+        screen.Post(screen.ExitLoopClosure());
+        break;
+    }
+    return container->Render();
+  });
+  screen.Loop(component);
+
+  EXPECT_EQ(log, std::vector<std::string>(
+                     {"+a", "-a", "+b", "-b", "+a", "-a"}));
+}
+
 // Copyright 2021 Arthur Sonzogni. All rights reserved.
 // Use of this source code is governed by the MIT license that can be found in
 // the LICENSE file.
@@ -39,7 +39,7 @@ class SliderBase : public ComponentBase {
            gauge_color | xflex | reflect(box_);
   }
 
-  bool OnEvent(Event event) final {
+  bool OnEvent(const Event& event) final {
     if (event.is_mouse())
       return OnMouseEvent(event);
 
@@ -58,7 +58,7 @@ class SliderBase : public ComponentBase {
     return ComponentBase::OnEvent(event);
   }
 
-  bool OnMouseEvent(Event event) {
+  bool OnMouseEvent(const Event& event) {
     if (captured_mouse_ && event.mouse().motion == Mouse::Released) {
       captured_mouse_ = nullptr;
       return true;
@@ -1,97 +1,223 @@
 #include "ftxui/component/terminal_input_parser.hpp"
 
-#include <algorithm>  // for max
-#include <cstdint>
-#include <memory>   // for unique_ptr
-#include <utility>  // for move
+#include <string.h>  // for memchr
+#include <utility>   // for move
 
 #include "ftxui/component/event.hpp"  // for Event
 
 namespace ftxui {
 
-TerminalInputParser::TerminalInputParser(Sender<Event> out)
-    : out_(std::move(out)) {}
+namespace {
+
+// Bigger values are clamped. This is enough for every known sequence.
+constexpr int kMaxParameter = 1'000'000;
+
+// Bracketed paste markers.
+constexpr char kPasteBegin[] = "\x1B[200~";
+constexpr char kPasteEnd[] = "\x1B[201~";
+constexpr size_t kPasteBeginSize = sizeof(kPasteBegin) - 1;
+constexpr size_t kPasteEndSize = sizeof(kPasteEnd) - 1;
+
+// A paste whose end marker was lost is sent as is, once no input followed it
+// for this long. A longer paste is sent in several parts of this size.
+constexpr std::chrono::milliseconds kPasteTimeout{1000};
+constexpr size_t kMaxPasteSize = 1 << 20;
+
+std::string EncodeUTF8(uint32_t codepoint) {
+  std::string out;
+  if (codepoint < 0x80) {
+    out += char(codepoint);
+  } else if (codepoint < 0x800) {
+    out += char(0b1100'0000 | (codepoint >> 6));
+    out += char(0b1000'0000 | (codepoint & 0b0011'1111));
+  } else if (codepoint < 0x10000) {
+    out += char(0b1110'0000 | (codepoint >> 12));
+    out += char(0b1000'0000 | ((codepoint >> 6) & 0b0011'1111));
+    out += char(0b1000'0000 | (codepoint & 0b0011'1111));
+  } else if (codepoint < 0x110000) {
+    out += char(0b1111'0000 | (codepoint >> 18));
+    out += char(0b1000'0000 | ((codepoint >> 12) & 0b0011'1111));
+    out += char(0b1000'0000 | ((codepoint >> 6) & 0b0011'1111));
+    out += char(0b1000'0000 | (codepoint & 0b0011'1111));
+  }
+  return out;
+}
+
+}  // namespace
+
+TerminalInputParser::TerminalInputParser(Sender<Task> out,
+                                         std::chrono::milliseconds timeout)
+    : out_(std::move(out)), timeout_(timeout) {}
 
-void TerminalInputParser::Timeout(int time) {
-  timeout_ += time;
-  if (timeout_ < 50)
+void TerminalInputParser::Timeout(TimePoint now) {
+  if (now < Deadline())
     return;
-  timeout_ = 0;
-  if (pending_.size())
-    Send(SPECIAL);
+  if (state_ == State::Paste)
+    EmitPaste(0);
+  else
+    Emit(Event::Special(std::move(pending_)));
+  Flush();
+}
+
+TerminalInputParser::TimePoint TerminalInputParser::Deadline() const {
+  if (pending_.empty())
+    return TimePoint::max();
+  return last_input_ + (state_ == State::Paste ? kPasteTimeout : timeout_);
 }
 
 void TerminalInputParser::Add(char c) {
-  pending_ += c;
-  timeout_ = 0;
-  position_ = -1;
-  Send(Parse());
+  Add(&c, 1);
+}
+
+void TerminalInputParser::Add(const char* data, size_t size) {
+  last_input_ = std::chrono::steady_clock::now();
+  size_t i = 0;
+  while (i < size) {
+    // Fast path: copy the pasted text up to the next ESC at once.
+    if (state_ == State::Paste && paste_end_matched_ == 0 &&
+        data[i] != '\x1B') {
+      const void* escape = memchr(data + i, '\x1B', size - i);
+      const size_t end = escape ? static_cast<const char*>(escape) - data : size;
+      pending_.append(data + i, end - i);
+      i = end;
+    } else {
+      Parse(static_cast<unsigned char>(data[i++]));
+    }
+
+    // A long paste is sent in several parts.
+    if (state_ == State::Paste && paste_end_matched_ == 0 &&
+        pending_.size() >= kMaxPasteSize) {
+      EmitPaste(0);
+      state_ = State::Paste;
+      pending_ = kPasteBegin;
+    }
+  }
+  Flush();
+}
+
+void TerminalInputParser::Emit(Event event) {
+  events_.push_back(std::move(event));
+  pending_.clear();
+  state_ = State::Ground;
 }
 
-unsigned char TerminalInputParser::Current() {
-  return pending_[position_];
+void TerminalInputParser::Drop() {
+  pending_.clear();
+  state_ = State::Ground;
 }
 
-bool TerminalInputParser::Eat() {
-  position_++;
-  return position_ < (int)pending_.size();
+void TerminalInputParser::Flush() {
+  if (!events_.empty())
+    out_->SendAll(&events_);
 }
 
-void TerminalInputParser::Send(TerminalInputParser::Output output) {
-  switch (output.type) {
-    case UNCOMPLETED:
+void TerminalInputParser::Parse(unsigned char c) {
+  pending_ += c;
+  switch (state_) {
+    case State::Ground:
+      ParseGround(c);
       return;
 
-    case DROP:
-      pending_.clear();
+    case State::UTF8:
+      ParseUTF8(c);
       return;
 
-    case CHARACTER:
-      out_->Send(Event::Character(std::move(pending_)));
-      pending_.clear();
+    case State::Escape:
+      switch (c) {
+        case '[':
+          state_ = State::CSI;
+          parameter_ = 0;
+          parameter_count_ = 0;
+          return;
+        case 'P':  // DCS
+        case ']':  // OSC
+          state_ = State::String;
+          return;
+        case 'O':  // SS3
+          state_ = State::EscapeFinal;
+          return;
+        case '\x1B':
+          // The first ESC was the Escape key. The second one starts a new
+          // sequence, like an arrow key.
+          events_.push_back(Event::Escape);
+          pending_ = "\x1B";
+          return;
+        default:  // Alt + key.
+          if (c >= 128)
+            return ParseUTF8Start(c);
+          Emit(Event::Special(std::move(pending_)));
+          return;
+      }
+
+    case State::EscapeFinal:
+      Emit(Event::Special(std::move(pending_)));
+      return;
+
+    case State::CSI:
+      ParseCSI(c);
       return;
 
-    case SPECIAL:
-      out_->Send(Event::Special(std::move(pending_)));
-      pending_.clear();
+    case State::String:
+      if (c == '\x1B')
+        state_ = State::StringEscape;
       return;
 
-    case MOUSE:
-      out_->Send(Event::Mouse(std::move(pending_), output.mouse));
-      pending_.clear();
+    case State::StringEscape:
+      if (c == '\\')
+        Emit(Event::Special(std::move(pending_)));
+      else
+        state_ = State::String;
       return;
 
-    case CURSOR_REPORTING:
-      out_->Send(Event::CursorReporting(std::move(pending_), output.cursor.x,
-                                        output.cursor.y));
-      pending_.clear();
+    case State::Paste:
+      ParsePaste(c);
       return;
   }
-  // NOT_REACHED().
 }
 
-TerminalInputParser::Output TerminalInputParser::Parse() {
-  if (!Eat())
-    return UNCOMPLETED;
-
-  switch (Current()) {
+void TerminalInputParser::ParseGround(unsigned char c) {
+  switch (c) {
     case 24:  // CAN
     case 26:  // SUB
-      return DROP;
+      Drop();
+      return;
 
     case '\x1B':
-      return ParseESC();
+      state_ = State::Escape;
+      return;
+
     default:
       break;
   }
 
-  if (Current() < 32)  // C0
-    return SPECIAL;
+  if (c < 32)  // C0
+    return Emit(Event::Special(std::move(pending_)));
 
-  if (Current() == 127)  // Delete
-    return SPECIAL;
+  if (c == 127)  // Delete
+    return Emit(Event::Special(std::move(pending_)));
 
-  return ParseUTF8();
+  if (c < 128)  // ASCII
+    return Emit(Event::Character(std::move(pending_)));
+
+  ParseUTF8Start(c);
+}
+
+// The first byte of a UTF-8 character. The next ones are read in the UTF8
+// state.
+void TerminalInputParser::ParseUTF8Start(unsigned char c) {
+  // Find the first zero in the first byte. It gives the size of the sequence.
+  int size = 0;
+  while (size < 8 && (c & (0b1000'0000 >> size)))
+    size++;
+
+  // Invalid UTF8: continuation byte, or more than 4 bytes.
+  if (size == 1 || size > 4)
+    return Drop();
+
+  utf8_size_ = size;
+  utf8_remaining_ = size - 1;
+  utf8_value_ = c & (0b0111'1111 >> size);
+  state_ = State::UTF8;
 }
 
 // Code point <-> UTF-8 conversion
@@ -110,190 +236,189 @@ TerminalInputParser::Output TerminalInputParser::Parse() {
 //
 // Then some sequences are illegal if it exist a shorter representation of the
 // same codepoint.
-TerminalInputParser::Output TerminalInputParser::ParseUTF8() {
-  unsigned char head = static_cast<unsigned char>(Current());
-  unsigned char selector = 0b1000'0000;
-
-  // The non code-point part of the first byte.
-  unsigned char mask = selector;
-
-  // Find the first zero in the first byte.
-  int first_zero = 8;
-  for (int i = 0; i < 8; ++i) {
-    mask |= selector;
-    if (head & selector) {
-      selector >>= 1;
-      continue;
-    }
-    first_zero = i;
-    break;
-  }
-
-  // Accumulate the value of the first byte.
-  uint32_t value = head & ~mask;
-
-  // Invalid UTF8, with more than 5 bytes.
-  if (first_zero == 1 || first_zero >= 5)
-    return DROP;
-
-  // Multi byte UTF-8.
-  for (int i = 2; i <= first_zero; ++i) {
-    if (!Eat())
-      return UNCOMPLETED;
-
-    // Invalid continuation byte.
-    head = static_cast<unsigned char>(Current());
-    if ((head & 0b1100'0000) != 0b1000'0000)
-      return DROP;
-    value <<= 6;
-    value += head & 0b0011'1111;
-  }
+void TerminalInputParser::ParseUTF8(unsigned char c) {
+  // Invalid continuation byte.
+  if ((c & 0b1100'0000) != 0b1000'0000)
+    return Drop();
+
+  utf8_value_ <<= 6;
+  utf8_value_ += c & 0b0011'1111;
+  if (--utf8_remaining_)
+    return;
 
   // Check for overlong UTF8 encoding.
   int extra_byte;
-  if (value <= 0b000'0000'0111'1111) {
+  if (utf8_value_ <= 0b000'0000'0111'1111) {
     extra_byte = 0;
-  } else if (value <= 0b000'0111'1111'1111) {
+  } else if (utf8_value_ <= 0b000'0111'1111'1111) {
     extra_byte = 1;
-  } else if (value <= 0b1111'1111'1111'1111) {
+  } else if (utf8_value_ <= 0b1111'1111'1111'1111) {
     extra_byte = 2;
-  } else if (value <= 0b1'0000'1111'1111'1111'1111) {
+  } else if (utf8_value_ <= 0b1'0000'1111'1111'1111'1111) {
     extra_byte = 3;
   } else {
-    return DROP;
+    return Drop();
   }
 
-  if (extra_byte != position_)
-    return DROP;
+  if (extra_byte != utf8_size_ - 1)
+    return Drop();
 
-  return CHARACTER;
-}
+  // Alt + character.
+  if (pending_[0] == '\x1B')
+    return Emit(Event::Special(std::move(pending_)));
 
-TerminalInputParser::Output TerminalInputParser::ParseESC() {
-  if (!Eat())
-    return UNCOMPLETED;
-  switch (Current()) {
-    case 'P':
-      return ParseDCS();
-    case '[':
-      return ParseCSI();
-    case ']':
-      return ParseOSC();
-    default:
-      if (!Eat())
-        return UNCOMPLETED;
-      return SPECIAL;
-  }
+  Emit(Event::Character(std::move(pending_)));
 }
 
-TerminalInputParser::Output TerminalInputParser::ParseDCS() {
-  // Parse until the string terminator ST.
-  while (1) {
-    if (!Eat())
-      return UNCOMPLETED;
-
-    if (Current() != '\x1B')
-      continue;
+void TerminalInputParser::ParseCSI(unsigned char c) {
+  // Ignore the SGR mouse mode marker.
+  if (c == '<')
+    return;
 
-    if (!Eat())
-      return UNCOMPLETED;
+  if (c >= '0' && c <= '9') {
+    if (parameter_ < kMaxParameter) {
+      parameter_ *= 10;
+      parameter_ += int(c - '0');
+    }
+    return;
+  }
 
-    if (Current() != '\\')
-      continue;
+  if (c == ';') {
+    if (parameter_count_ < kMaxParameters)
+      parameters_[parameter_count_] = parameter_;
+    parameter_count_++;
+    parameter_ = 0;
+    return;
+  }
 
-    return SPECIAL;
+  if (c >= ' ' && c <= '~') {
+    if (parameter_count_ < kMaxParameters)
+      parameters_[parameter_count_] = parameter_;
+    parameter_count_++;
+    parameter_ = 0;
+    ParseCSIFinal(c);
+    return;
   }
+
+  // Invalid ESC in CSI.
+  if (c == '\x1B')
+    Emit(Event::Special(std::move(pending_)));
 }
 
-TerminalInputParser::Output TerminalInputParser::ParseCSI() {
-  bool altered = false;
-  int argument = 0;
-  std::vector<int> arguments;
-  while (true) {
-    if (!Eat())
-      return UNCOMPLETED;
-
-    if (Current() == '<') {
-      altered = true;
-      continue;
-    }
+void TerminalInputParser::ParseCSIFinal(unsigned char c) {
+  switch (c) {
+    case 'M':
+      return ParseMouse(true);
+    case 'm':
+      return ParseMouse(false);
+    case 'R':
+      return ParseCursorReporting();
+    case 'u':
+      return ParseKeyboard();
+    case '~':
+      if (pending_ == kPasteBegin) {
+        state_ = State::Paste;
+        paste_end_matched_ = 0;
+        return;
+      }
+      return Emit(Event::Special(std::move(pending_)));
+    default:
+      return Emit(Event::Special(std::move(pending_)));
+  }
+}
 
-    if (Current() >= '0' && Current() <= '9') {
-      argument *= 10;
-      argument += int(Current() - '0');
-      continue;
-    }
+void TerminalInputParser::ParseMouse(bool pressed) {
+  if (parameter_count_ != 3)
+    return Emit(Event::Special(std::move(pending_)));
+
+  Mouse mouse;
+  mouse.button = Mouse::Button((parameters_[0] & 3) +  //
+                               ((parameters_[0] & 64) >> 4));
+  mouse.motion = (parameters_[0] & 32) ? Mouse::Moved : Mouse::Motion(pressed);
+  mouse.shift = bool(parameters_[0] & 4);
+  mouse.meta = bool(parameters_[0] & 8);
+  mouse.control = bool(parameters_[0] & 16);
+  mouse.x = parameters_[1];
+  mouse.y = parameters_[2];
+  Emit(Event::Mouse(std::move(pending_), mouse));
+}
 
-    if (Current() == ';') {
-      arguments.push_back(argument);
-      argument = 0;
-      continue;
-    }
+void TerminalInputParser::ParseCursorReporting() {
+  if (parameter_count_ != 2)
+    return Emit(Event::Special(std::move(pending_)));
+  Emit(Event::CursorReporting(std::move(pending_), parameters_[1],
+                              parameters_[0]));
+}
 
-    if (Current() >= ' ' && Current() <= '~' && Current() != '<') {
-      arguments.push_back(argument);
-      argument = 0;
-      switch (Current()) {
-        case 'M':
-          return ParseMouse(altered, true, std::move(arguments));
-        case 'm':
-          return ParseMouse(altered, false, std::move(arguments));
-        case 'R':
-          return ParseCursorReporting(std::move(arguments));
-        default:
-          return SPECIAL;
-      }
+// Kitty keyboard protocol: CSI key-code ; modifiers u
+// The keys are converted into their legacy encoding, when they have one.
+void TerminalInputParser::ParseKeyboard() {
+  if (parameter_count_ > 2)
+    return Emit(Event::Special(std::move(pending_)));
+
+  const int kShift = 1;
+  const int kAlt = 2;
+  const int kControl = 4;
+  const int kCapsLock = 64;
+  const int kNumLock = 128;
+
+  const int key = parameters_[0];
+  int modifiers = parameter_count_ == 2 ? parameters_[1] - 1 : 0;
+  // The lock states aren't modifiers of the key.
+  modifiers &= ~(kCapsLock | kNumLock);
+
+  std::string legacy;
+  if (modifiers == 0 || modifiers == kAlt) {
+    switch (key) {
+      case 9:
+        legacy = Event::Tab.input();
+        break;
+      case 13:
+        legacy = Event::Return.input();
+        break;
+      case 27:
+        legacy = Event::Escape.input();
+        break;
+      case 127:
+        legacy = Event::Backspace.input();
+        break;
+      default:
+        // The functional keys are in the private use area.
+        if (key >= 32 && (key < 0xE000 || key > 0xF8FF))
+          legacy = EncodeUTF8(key);
+        break;
     }
-
-    // Invalid ESC in CSI.
-    if (Current() == '\x1B')
-      return SPECIAL;
+    if (!legacy.empty() && modifiers == kAlt)
+      legacy = "\x1B" + legacy;
+  } else if (modifiers == kShift && key == 9) {
+    legacy = Event::TabReverse.input();
+  } else if (modifiers == kControl && key >= 'a' && key <= 'z') {
+    legacy = std::string(1, char(key & 0x1F));
   }
+
+  if (legacy.empty())
+    return Emit(Event::Special(std::move(pending_)));
+  if (modifiers == 0 && key >= 32 && key != 127)
+    return Emit(Event::Character(std::move(legacy)));
+  Emit(Event::Special(std::move(legacy)));
 }
 
-TerminalInputParser::Output TerminalInputParser::ParseOSC() {
-  // Parse until the string terminator ST.
-  while (true) {
-    if (!Eat())
-      return UNCOMPLETED;
-    if (Current() != '\x1B')
-      continue;
-    if (!Eat())
-      return UNCOMPLETED;
-    if (Current() != '\\')
-      continue;
-    return SPECIAL;
+void TerminalInputParser::ParsePaste(unsigned char c) {
+  if (c != kPasteEnd[paste_end_matched_]) {
+    paste_end_matched_ = (c == '\x1B') ? 1 : 0;
+    return;
   }
-}
+  if (++paste_end_matched_ != kPasteEndSize)
+    return;
 
-TerminalInputParser::Output TerminalInputParser::ParseMouse(
-    bool altered,
-    bool pressed,
-    std::vector<int> arguments) {
-  if (arguments.size() != 3)
-    return SPECIAL;
-
-  (void)altered;
-
-  Output output(MOUSE);
-  output.mouse.button = Mouse::Button((arguments[0] & 3) +  //
-                                      ((arguments[0] & 64) >> 4));
-  output.mouse.motion = Mouse::Motion(pressed);
-  output.mouse.shift = bool(arguments[0] & 4);
-  output.mouse.meta = bool(arguments[0] & 8);
-  output.mouse.x = arguments[1];
-  output.mouse.y = arguments[2];
-  return output;
+  EmitPaste(kPasteEndSize);
 }
 
-TerminalInputParser::Output TerminalInputParser::ParseCursorReporting(
-    std::vector<int> arguments) {
-  if (arguments.size() != 2)
-    return SPECIAL;
-  Output output(CURSOR_REPORTING);
-  output.cursor.y = arguments[0];
-  output.cursor.x = arguments[1];
-  return output;
+// Send the pasted text, without the start marker and the |end_size| last
+// characters.
+void TerminalInputParser::EmitPaste(size_t end_size) {
+  const size_t size = pending_.size() - kPasteBeginSize - end_size;
+  Emit(Event::Paste(pending_.substr(kPasteBeginSize, size)));
 }
 
 }  // namespace ftxui
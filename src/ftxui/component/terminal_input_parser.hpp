@@ -1,66 +1,98 @@
 #ifndef FTXUI_COMPONENT_TERMINAL_INPUT_PARSER
 #define FTXUI_COMPONENT_TERMINAL_INPUT_PARSER
 
-#include <memory>  // for unique_ptr
-#include <string>  // for string
-#include <vector>  // for vector
+#include <stddef.h>  // for size_t
+#include <stdint.h>  // for uint32_t
+#include <chrono>    // for steady_clock, milliseconds
+#include <string>    // for string
+#include <vector>    // for vector
 
 #include "ftxui/component/event.hpp"     // for Event (ptr only)
 #include "ftxui/component/mouse.hpp"     // for Mouse
 #include "ftxui/component/receiver.hpp"  // for Sender
+#include "ftxui/component/task.hpp"      // for Task
 
 namespace ftxui {
 struct Event;
 
 // Parse a sequence of |char| accross |time|. Produces |Event|.
+//
+// This is a state machine: every character is read once, and the state is
+// kept in between two calls to Add(). The events parsed by a call are sent
+// together.
+//
+// A lone ESC can't be distinguished from the beginning of a sequence. It is
+// sent as Event::Escape once no character followed it for |timeout|. The
+// kitty keyboard protocol (CSI u) avoids this wait, by encoding the Escape key
+// as a sequence.
 class TerminalInputParser {
  public:
-  TerminalInputParser(Sender<Event> out);
-  void Timeout(int time);
+  using TimePoint = std::chrono::steady_clock::time_point;
+  static constexpr std::chrono::milliseconds kDefaultTimeout{50};
+
+  TerminalInputParser(Sender<Task> out,
+                      std::chrono::milliseconds timeout = kDefaultTimeout);
   void Add(char c);
+  void Add(const char* data, size_t size);
+
+  // Send the pending characters, if they are incomplete at |now|.
+  void Timeout(TimePoint now);
+  // When the pending characters are to be sent, if nothing follows them.
+  // TimePoint::max() when there are none.
+  TimePoint Deadline() const;
+
+  // Whether some characters are waiting to be completed, or a Timeout().
+  bool HasPending() const { return !pending_.empty(); }
 
  private:
-  unsigned char Current();
-  bool Eat();
-
-  enum Type {
-    UNCOMPLETED,
-    DROP,
-    CHARACTER,
-    SPECIAL,
-    MOUSE,
-    CURSOR_REPORTING,
+  enum class State {
+    Ground,
+    UTF8,          // Waiting for UTF-8 continuation bytes, after ESC or not.
+    Escape,        // After ESC.
+    EscapeFinal,   // After ESC and an other character.
+    CSI,           // Control Sequence Introducer: ESC [
+    String,        // DCS or OSC, until the string terminator ST.
+    StringEscape,  // After ESC in a string.
+    Paste,         // Bracketed paste, until ESC [ 201 ~
   };
 
-  struct CursorReporting {
-    int x;
-    int y;
-  };
+  void Parse(unsigned char c);
+  void ParseGround(unsigned char c);
+  void ParseUTF8Start(unsigned char c);
+  void ParseUTF8(unsigned char c);
+  void ParseCSI(unsigned char c);
+  void ParseCSIFinal(unsigned char c);
+  void ParseMouse(bool pressed);
+  void ParseCursorReporting();
+  void ParsePaste(unsigned char c);
+  void EmitPaste(size_t end_size);
+  void ParseKeyboard();
 
-  struct Output {
-    Type type;
-    union {
-      Mouse mouse;
-      CursorReporting cursor;
-    };
+  // Send the |pending_| characters as an event, or drop them.
+  void Emit(Event event);
+  void Drop();
+  void Flush();
 
-    Output(Type t) : type(t) {}
-  };
-
-  void Send(Output type);
-  Output Parse();
-  Output ParseUTF8();
-  Output ParseESC();
-  Output ParseDCS();
-  Output ParseCSI();
-  Output ParseOSC();
-  Output ParseMouse(bool altered, bool pressed, std::vector<int> arguments);
-  Output ParseCursorReporting(std::vector<int> arguments);
-
-  Sender<Event> out_;
-  int position_ = -1;
-  int timeout_ = 0;
+  Sender<Task> out_;
+  std::vector<Task> events_;
+  State state_ = State::Ground;
   std::string pending_;
+  std::chrono::milliseconds timeout_;
+  TimePoint last_input_;
+
+  // UTF8:
+  int utf8_size_ = 0;
+  int utf8_remaining_ = 0;
+  uint32_t utf8_value_ = 0;
+
+  // CSI:
+  static constexpr int kMaxParameters = 16;
+  int parameter_ = 0;
+  int parameter_count_ = 0;
+  int parameters_[kMaxParameters];
+
+  // Paste: the number of characters of the end marker matched.
+  size_t paste_end_matched_ = 0;
 };
 
 }  // namespace ftxui
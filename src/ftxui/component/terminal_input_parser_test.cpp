@@ -1,10 +1,17 @@
 #include <gtest/gtest-message.h>  // for Message
 #include <gtest/gtest-test-part.h>  // for TestPartResult, SuiteApiResolver, TestFactoryImpl
 #include <algorithm>                // for max
+#include <chrono>                   // for milliseconds, steady_clock
 #include <memory>                   // for unique_ptr, allocator
+#include <string>                   // for string
+#include <thread>                   // for thread
+#include <utility>                  // for pair
+#include <vector>                   // for vector
+#include <variant>                  // for get
 
 #include "ftxui/component/event.hpp"     // for Event, Event::Escape
 #include "ftxui/component/receiver.hpp"  // for MakeReceiver, ReceiverImpl
+#include "ftxui/component/task.hpp"      // for Task
 #include "ftxui/component/terminal_input_parser.hpp"
 #include "gtest/gtest_pred_impl.h"  // for AssertionResult, Test, EXPECT_EQ, EXPECT_TRUE, EXPECT_FALSE, TEST
 
@@ -18,61 +25,166 @@ TEST(Event, Character) {
   for (char c = 'A'; c <= 'Z'; ++c)
     basic_char.push_back(c);
 
-  auto event_receiver = MakeReceiver<Event>();
+  auto event_receiver = MakeReceiver<Task>();
   {
     auto parser = TerminalInputParser(event_receiver->MakeSender());
     for (char c : basic_char)
       parser.Add(c);
   }
 
-  Event received;
+  Task received;
   for (char c : basic_char) {
     EXPECT_TRUE(event_receiver->Receive(&received));
-    EXPECT_TRUE(received.is_character());
-    EXPECT_EQ(c, received.character()[0]);
+    EXPECT_TRUE(std::get<Event>(received).is_character());
+    EXPECT_EQ(c, std::get<Event>(received).character()[0]);
   }
   EXPECT_FALSE(event_receiver->Receive(&received));
 }
 
 TEST(Event, EscapeKeyWithoutWaiting) {
-  auto event_receiver = MakeReceiver<Event>();
+  auto event_receiver = MakeReceiver<Task>();
   {
     auto parser = TerminalInputParser(event_receiver->MakeSender());
     parser.Add('\x1B');
   }
 
-  Event received;
+  Task received;
   EXPECT_FALSE(event_receiver->Receive(&received));
 }
 
 TEST(Event, EscapeKeyNotEnoughWait) {
-  auto event_receiver = MakeReceiver<Event>();
+  auto event_receiver = MakeReceiver<Task>();
   {
     auto parser = TerminalInputParser(event_receiver->MakeSender());
     parser.Add('\x1B');
-    parser.Timeout(49);
+    parser.Timeout(parser.Deadline() - std::chrono::milliseconds(1));
   }
 
-  Event received;
+  Task received;
   EXPECT_FALSE(event_receiver->Receive(&received));
 }
 
 TEST(Event, EscapeKeyEnoughWait) {
-  auto event_receiver = MakeReceiver<Event>();
+  auto event_receiver = MakeReceiver<Task>();
   {
     auto parser = TerminalInputParser(event_receiver->MakeSender());
     parser.Add('\x1B');
-    parser.Timeout(50);
+    parser.Timeout(parser.Deadline());
   }
 
-  Event received;
+  Task received;
   EXPECT_TRUE(event_receiver->Receive(&received));
-  EXPECT_EQ(received, Event::Escape);
+  EXPECT_EQ(std::get<Event>(received), Event::Escape);
   EXPECT_FALSE(event_receiver->Receive(&received));
 }
 
+TEST(Event, EscapeKeyCustomTimeout) {
+  auto event_receiver = MakeReceiver<Task>();
+  {
+    auto parser = TerminalInputParser(event_receiver->MakeSender(),
+                                      std::chrono::milliseconds(10));
+    const auto before = std::chrono::steady_clock::now();
+    parser.Add('\x1B');
+    EXPECT_LE(parser.Deadline(), std::chrono::steady_clock::now() +
+                                     std::chrono::milliseconds(10));
+    EXPECT_GE(parser.Deadline(), before + std::chrono::milliseconds(10));
+    parser.Timeout(parser.Deadline());
+  }
+
+  Task received;
+  EXPECT_TRUE(event_receiver->Receive(&received));
+  EXPECT_EQ(std::get<Event>(received), Event::Escape);
+  EXPECT_FALSE(event_receiver->Receive(&received));
+}
+
+// ESC followed by a key is reported without waiting for a third byte.
+TEST(Event, AltKeyWithoutWaiting) {
+  auto event_receiver = MakeReceiver<Task>();
+  {
+    auto parser = TerminalInputParser(event_receiver->MakeSender());
+    parser.Add("\x1B" "a", 2);
+    EXPECT_FALSE(parser.HasPending());
+  }
+
+  Task received;
+  EXPECT_TRUE(event_receiver->Receive(&received));
+  EXPECT_EQ(std::get<Event>(received), Event::Special("\x1B" "a"));
+  EXPECT_FALSE(event_receiver->Receive(&received));
+}
+
+// An Escape key followed by an arrow key, or Alt+Arrow sent as ESC ESC [ A.
+TEST(Event, EscapeThenSequence) {
+  auto event_receiver = MakeReceiver<Task>();
+  {
+    auto parser = TerminalInputParser(event_receiver->MakeSender());
+    parser.Add("\x1B\x1B[A", 4);
+    EXPECT_FALSE(parser.HasPending());
+  }
+
+  Task received;
+  EXPECT_TRUE(event_receiver->Receive(&received));
+  EXPECT_EQ(std::get<Event>(received), Event::Escape);
+  EXPECT_TRUE(event_receiver->Receive(&received));
+  EXPECT_EQ(std::get<Event>(received), Event::ArrowUp);
+  EXPECT_FALSE(event_receiver->Receive(&received));
+}
+
+// Alt with a non ASCII key: the whole character follows ESC.
+TEST(Event, AltUTF8Key) {
+  const std::string input = "\x1B\xC3\xA9" "a";
+  for (size_t split = 0; split <= input.size(); ++split) {
+    auto event_receiver = MakeReceiver<Task>();
+    {
+      auto parser = TerminalInputParser(event_receiver->MakeSender());
+      parser.Add(input.data(), split);
+      parser.Add(input.data() + split, input.size() - split);
+      EXPECT_FALSE(parser.HasPending());
+    }
+
+    Task received;
+    EXPECT_TRUE(event_receiver->Receive(&received));
+    EXPECT_EQ(std::get<Event>(received), Event::Special("\x1B\xC3\xA9"));
+    EXPECT_TRUE(event_receiver->Receive(&received));
+    EXPECT_EQ(std::get<Event>(received), Event::Character("a"));
+    EXPECT_FALSE(event_receiver->Receive(&received));
+  }
+}
+
+// Keys reported by the kitty keyboard protocol are translated into their
+// legacy encoding.
+TEST(Event, KittyKeyboardProtocol) {
+  const std::vector<std::pair<std::string, Event>> tests = {
+      {"\x1B[27u", Event::Escape},
+      {"\x1B[13u", Event::Return},
+      {"\x1B[9u", Event::Tab},
+      {"\x1B[9;2u", Event::TabReverse},
+      {"\x1B[127u", Event::Backspace},
+      {"\x1B[97;5u", Event::Special("\x01")},   // Ctrl+a
+      {"\x1B[97;3u", Event::Special("\x1B" "a")},  // Alt+a
+      {"\x1B[8364u", Event::Character("\xE2\x82\xAC")},
+      {"\x1B[57399u", Event::Special("\x1B[57399u")},  // Keypad 0.
+      {"\x1B[27;129u", Event::Escape},                 // Num lock.
+      {"\x1B[13;65u", Event::Return},                  // Caps lock.
+      {"\x1B[97;197u", Event::Special("\x01")},        // Ctrl+a, both locks.
+  };
+
+  for (const auto& test : tests) {
+    auto event_receiver = MakeReceiver<Task>();
+    {
+      auto parser = TerminalInputParser(event_receiver->MakeSender());
+      parser.Add(test.first.data(), test.first.size());
+      EXPECT_FALSE(parser.HasPending());
+    }
+
+    Task received;
+    EXPECT_TRUE(event_receiver->Receive(&received));
+    EXPECT_EQ(std::get<Event>(received), test.second) << test.first;
+    EXPECT_FALSE(event_receiver->Receive(&received));
+  }
+}
+
 TEST(Event, MouseLeftClick) {
-  auto event_receiver = MakeReceiver<Event>();
+  auto event_receiver = MakeReceiver<Task>();
   {
     auto parser = TerminalInputParser(event_receiver->MakeSender());
     parser.Add('\x1B');
@@ -88,17 +200,38 @@ TEST(Event, MouseLeftClick) {
     parser.Add('M');
   }
 
-  Event received;
+  Task received;
   EXPECT_TRUE(event_receiver->Receive(&received));
-  EXPECT_TRUE(received.is_mouse());
-  EXPECT_EQ(Mouse::Left, received.mouse().button);
-  EXPECT_EQ(12, received.mouse().x);
-  EXPECT_EQ(42, received.mouse().y);
+  EXPECT_TRUE(std::get<Event>(received).is_mouse());
+  EXPECT_EQ(Mouse::Left, std::get<Event>(received).mouse().button);
+  EXPECT_EQ(12, std::get<Event>(received).mouse().x);
+  EXPECT_EQ(42, std::get<Event>(received).mouse().y);
+  EXPECT_FALSE(event_receiver->Receive(&received));
+}
+
+TEST(Event, MouseMotion) {
+  auto event_receiver = MakeReceiver<Task>();
+  {
+    auto parser = TerminalInputParser(event_receiver->MakeSender());
+    for (char c : std::string("\x1B[<35;1;2M\x1B[<0;1;2M\x1B[<64;1;2M"))
+      parser.Add(c);
+  }
+
+  Task received;
+  EXPECT_TRUE(event_receiver->Receive(&received));
+  EXPECT_EQ(Mouse::None, std::get<Event>(received).mouse().button);
+  EXPECT_EQ(Mouse::Moved, std::get<Event>(received).mouse().motion);
+  EXPECT_TRUE(event_receiver->Receive(&received));
+  EXPECT_EQ(Mouse::Left, std::get<Event>(received).mouse().button);
+  EXPECT_EQ(Mouse::Pressed, std::get<Event>(received).mouse().motion);
+  EXPECT_TRUE(event_receiver->Receive(&received));
+  EXPECT_EQ(Mouse::WheelUp, std::get<Event>(received).mouse().button);
+  EXPECT_EQ(Mouse::Pressed, std::get<Event>(received).mouse().motion);
   EXPECT_FALSE(event_receiver->Receive(&received));
 }
 
 TEST(Event, MouseMiddleClick) {
-  auto event_receiver = MakeReceiver<Event>();
+  auto event_receiver = MakeReceiver<Task>();
   {
     auto parser = TerminalInputParser(event_receiver->MakeSender());
     parser.Add('\x1B');
@@ -114,17 +247,17 @@ TEST(Event, MouseMiddleClick) {
     parser.Add('M');
   }
 
-  Event received;
+  Task received;
   EXPECT_TRUE(event_receiver->Receive(&received));
-  EXPECT_TRUE(received.is_mouse());
-  EXPECT_EQ(Mouse::Middle, received.mouse().button);
-  EXPECT_EQ(12, received.mouse().x);
-  EXPECT_EQ(42, received.mouse().y);
+  EXPECT_TRUE(std::get<Event>(received).is_mouse());
+  EXPECT_EQ(Mouse::Middle, std::get<Event>(received).mouse().button);
+  EXPECT_EQ(12, std::get<Event>(received).mouse().x);
+  EXPECT_EQ(42, std::get<Event>(received).mouse().y);
   EXPECT_FALSE(event_receiver->Receive(&received));
 }
 
 TEST(Event, MouseRightClick) {
-  auto event_receiver = MakeReceiver<Event>();
+  auto event_receiver = MakeReceiver<Task>();
   {
     auto parser = TerminalInputParser(event_receiver->MakeSender());
     parser.Add('\x1B');
@@ -140,12 +273,12 @@ TEST(Event, MouseRightClick) {
     parser.Add('M');
   }
 
-  Event received;
+  Task received;
   EXPECT_TRUE(event_receiver->Receive(&received));
-  EXPECT_TRUE(received.is_mouse());
-  EXPECT_EQ(Mouse::Right, received.mouse().button);
-  EXPECT_EQ(12, received.mouse().x);
-  EXPECT_EQ(42, received.mouse().y);
+  EXPECT_TRUE(std::get<Event>(received).is_mouse());
+  EXPECT_EQ(Mouse::Right, std::get<Event>(received).mouse().button);
+  EXPECT_EQ(12, std::get<Event>(received).mouse().x);
+  EXPECT_EQ(42, std::get<Event>(received).mouse().y);
   EXPECT_FALSE(event_receiver->Receive(&received));
 }
 
@@ -216,21 +349,149 @@ TEST(Event, UTF8) {
 
   };
   for (auto test : kTestCase) {
-    auto event_receiver = MakeReceiver<Event>();
+    auto event_receiver = MakeReceiver<Task>();
     {
       auto parser = TerminalInputParser(event_receiver->MakeSender());
       for (auto input : test.input)
         parser.Add(input);
     }
-    Event received;
+    Task received;
     if (test.valid) {
       EXPECT_TRUE(event_receiver->Receive(&received));
-      EXPECT_TRUE(received.is_character());
+      EXPECT_TRUE(std::get<Event>(received).is_character());
+    }
+    EXPECT_FALSE(event_receiver->Receive(&received));
+  }
+}
+
+TEST(Event, SplitSequences) {
+  // A mouse event, an UTF-8 character and a key, split at every position.
+  const std::string input = "\x1B[<0;12;42M\xE2\x82\xAC" "a";
+  for (size_t split = 0; split <= input.size(); ++split) {
+    auto event_receiver = MakeReceiver<Task>();
+    {
+      auto parser = TerminalInputParser(event_receiver->MakeSender());
+      parser.Add(input.data(), split);
+      parser.Add(input.data() + split, input.size() - split);
+    }
+
+    Task received;
+    EXPECT_TRUE(event_receiver->Receive(&received));
+    EXPECT_TRUE(std::get<Event>(received).is_mouse());
+    EXPECT_EQ(12, std::get<Event>(received).mouse().x);
+    EXPECT_EQ(42, std::get<Event>(received).mouse().y);
+    EXPECT_TRUE(event_receiver->Receive(&received));
+    EXPECT_EQ(std::get<Event>(received), Event::Character("\xE2\x82\xAC"));
+    EXPECT_TRUE(event_receiver->Receive(&received));
+    EXPECT_EQ(std::get<Event>(received), Event::Character("a"));
+    EXPECT_FALSE(event_receiver->Receive(&received));
+  }
+}
+
+TEST(Event, ManyParameters) {
+  auto event_receiver = MakeReceiver<Task>();
+  {
+    auto parser = TerminalInputParser(event_receiver->MakeSender());
+    std::string input = "\x1B[";
+    for (int i = 0; i < 100; ++i)
+      input += "99999999999;";
+    input += "M";
+    parser.Add(input.data(), input.size());
+  }
+
+  // Not a valid mouse event.
+  Task received;
+  EXPECT_TRUE(event_receiver->Receive(&received));
+  EXPECT_FALSE(std::get<Event>(received).is_mouse());
+  EXPECT_FALSE(event_receiver->Receive(&received));
+}
+
+TEST(Event, Bulk) {
+  // More characters than the receiver capacity, sent at once.
+  auto event_receiver = MakeReceiver<Task>(16);
+  const std::string input(10000, 'a');
+  std::thread producer([&, sender = event_receiver->MakeSender()]() mutable {
+    auto parser = TerminalInputParser(std::move(sender));
+    parser.Add(input.data(), input.size());
+  });
+
+  int count = 0;
+  Task received;
+  while (event_receiver->Receive(&received))
+    count++;
+  producer.join();
+  EXPECT_EQ(count, 10000);
+}
+
+TEST(Event, BracketedPaste) {
+  // The end marker is split between two chunks. The pasted text contains an
+  // ESC, and a partial end marker.
+  const std::string text = "a\x1B[201b\x1B[D\xE2\x82\xAC";
+  const std::string input = "\x1B[200~" + text + "\x1B[201~b";
+  for (size_t split = 0; split <= input.size(); ++split) {
+    auto event_receiver = MakeReceiver<Task>();
+    {
+      auto parser = TerminalInputParser(event_receiver->MakeSender());
+      parser.Add(input.data(), split);
+      // A short pause doesn't interrupt the paste.
+      parser.Timeout(std::chrono::steady_clock::now());
+      parser.Add(input.data() + split, input.size() - split);
     }
+
+    Task received;
+    EXPECT_TRUE(event_receiver->Receive(&received));
+    EXPECT_TRUE(std::get<Event>(received).is_paste());
+    EXPECT_EQ(std::get<Event>(received).paste(), text);
+    EXPECT_TRUE(event_receiver->Receive(&received));
+    EXPECT_EQ(std::get<Event>(received), Event::Character("b"));
     EXPECT_FALSE(event_receiver->Receive(&received));
   }
 }
 
+// The end marker of the paste is lost. The text is sent after a timeout.
+TEST(Event, BracketedPasteWithoutEnd) {
+  auto event_receiver = MakeReceiver<Task>();
+  {
+    auto parser = TerminalInputParser(event_receiver->MakeSender());
+    parser.Add("\x1B[200~abc", 9);
+    EXPECT_NE(parser.Deadline(), TerminalInputParser::TimePoint::max());
+    parser.Timeout(parser.Deadline());
+    EXPECT_FALSE(parser.HasPending());
+    parser.Add('d');
+  }
+
+  Task received;
+  EXPECT_TRUE(event_receiver->Receive(&received));
+  EXPECT_TRUE(std::get<Event>(received).is_paste());
+  EXPECT_EQ(std::get<Event>(received).paste(), "abc");
+  EXPECT_TRUE(event_receiver->Receive(&received));
+  EXPECT_EQ(std::get<Event>(received), Event::Character("d"));
+  EXPECT_FALSE(event_receiver->Receive(&received));
+}
+
+// A long paste is sent in several parts, without being held in memory.
+TEST(Event, BracketedPasteLong) {
+  const std::string text(3'000'000, 'a');
+  const std::string input = "\x1B[200~" + text + "\x1B[201~";
+  auto event_receiver = MakeReceiver<Task>();
+  {
+    auto parser = TerminalInputParser(event_receiver->MakeSender());
+    for (size_t i = 0; i < input.size(); i += 4096)
+      parser.Add(input.data() + i, std::min<size_t>(4096, input.size() - i));
+  }
+
+  std::string pasted;
+  int parts = 0;
+  Task received;
+  while (event_receiver->Receive(&received)) {
+    EXPECT_TRUE(std::get<Event>(received).is_paste());
+    pasted += std::get<Event>(received).paste();
+    parts++;
+  }
+  EXPECT_EQ(pasted, text);
+  EXPECT_EQ(parts, 3);
+}
+
 // Copyright 2020 Arthur Sonzogni. All rights reserved.
 // Use of this source code is governed by the MIT license that can be found in
 // the LICENSE file.
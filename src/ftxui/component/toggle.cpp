@@ -54,7 +54,7 @@ class ToggleBase : public ComponentBase {
     return hbox(std::move(children));
   }
 
-  bool OnEvent(Event event) override {
+  bool OnEvent(const Event& event) override {
     if (event.is_mouse())
       return OnMouseEvent(event);
 
@@ -84,7 +84,7 @@ class ToggleBase : public ComponentBase {
     return false;
   }
 
-  bool OnMouseEvent(Event event) {
+  bool OnMouseEvent(const Event& event) {
     if (!CaptureMouse(event))
       return false;
     for (int i = 0; i < int(boxes_.size()); ++i) {
@@ -15,9 +15,11 @@ class Blink : public NodeDecorator {
 
   void Render(Screen& screen) override {
     Node::Render(screen);
-    for (int y = box_.y_min; y <= box_.y_max; ++y) {
-      for (int x = box_.x_min; x <= box_.x_max; ++x) {
-        screen.PixelAt(x, y).blink = true;
+    const Box box = Box::Intersection(box_, screen.stencil);
+    for (int y = box.y_min; y <= box.y_max; ++y) {
+      Pixel* line = screen.Row(y);
+      for (int x = box.x_min; x <= box.x_max; ++x) {
+        line[x].blink = true;
       }
     }
   }
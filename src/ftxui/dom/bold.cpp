@@ -14,9 +14,11 @@ class Bold : public NodeDecorator {
   using NodeDecorator::NodeDecorator;
 
   void Render(Screen& screen) override {
-    for (int y = box_.y_min; y <= box_.y_max; ++y) {
-      for (int x = box_.x_min; x <= box_.x_max; ++x) {
-        screen.PixelAt(x, y).bold = true;
+    const Box box = Box::Intersection(box_, screen.stencil);
+    for (int y = box.y_min; y <= box.y_max; ++y) {
+      Pixel* line = screen.Row(y);
+      for (int x = box.x_min; x <= box.x_max; ++x) {
+        line[x].bold = true;
       }
     }
     Node::Render(screen);
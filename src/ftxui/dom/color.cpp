@@ -15,9 +15,11 @@ class BgColor : public NodeDecorator {
       : NodeDecorator(std::move(child)), color_(color) {}
 
   void Render(Screen& screen) override {
-    for (int y = box_.y_min; y <= box_.y_max; ++y) {
-      for (int x = box_.x_min; x <= box_.x_max; ++x) {
-        screen.PixelAt(x, y).background_color = color_;
+    const Box box = Box::Intersection(box_, screen.stencil);
+    for (int y = box.y_min; y <= box.y_max; ++y) {
+      Pixel* line = screen.Row(y);
+      for (int x = box.x_min; x <= box.x_max; ++x) {
+        line[x].background_color = color_;
       }
     }
     NodeDecorator::Render(screen);
@@ -32,9 +34,11 @@ class FgColor : public NodeDecorator {
       : NodeDecorator(std::move(child)), color_(color) {}
 
   void Render(Screen& screen) override {
-    for (int y = box_.y_min; y <= box_.y_max; ++y) {
-      for (int x = box_.x_min; x <= box_.x_max; ++x) {
-        screen.PixelAt(x, y).foreground_color = color_;
+    const Box box = Box::Intersection(box_, screen.stencil);
+    for (int y = box.y_min; y <= box.y_max; ++y) {
+      Pixel* line = screen.Row(y);
+      for (int x = box.x_min; x <= box.x_max; ++x) {
+        line[x].foreground_color = color_;
       }
     }
     NodeDecorator::Render(screen);
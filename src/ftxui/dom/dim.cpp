@@ -15,9 +15,11 @@ class Dim : public NodeDecorator {
 
   void Render(Screen& screen) override {
     Node::Render(screen);
-    for (int y = box_.y_min; y <= box_.y_max; ++y) {
-      for (int x = box_.x_min; x <= box_.x_max; ++x) {
-        screen.PixelAt(x, y).dim = true;
+    const Box box = Box::Intersection(box_, screen.stencil);
+    for (int y = box.y_min; y <= box.y_max; ++y) {
+      Pixel* line = screen.Row(y);
+      for (int x = box.x_min; x <= box.x_max; ++x) {
+        line[x].dim = true;
       }
     }
   }
@@ -1,6 +1,7 @@
 #include "ftxui/screen/color.hpp"
 
-#include <cassert>
+#include <array>    // for array
+#include <cassert>  // for assert
 
 #include "ftxui/screen/color_info.hpp"  // for GetColorInfo, ColorInfo
 #include "ftxui/screen/terminal.hpp"  // for Terminal, Terminal::Color, Terminal::Palette256, Terminal::TrueColor
@@ -14,8 +15,34 @@ const char* palette16code[16][2] = {
     {"90", "100"}, {"91", "101"}, {"92", "102"}, {"93", "103"},
     {"94", "104"}, {"95", "105"}, {"96", "106"}, {"97", "107"},
 };
+
+// The decimal representation of every uint8_t.
+struct Decimal {
+  char data[3];
+  uint8_t size;
+};
+
+constexpr std::array<Decimal, 256> BuildDecimalTable() {
+  std::array<Decimal, 256> table = {};
+  for (int i = 0; i < 256; ++i) {
+    Decimal& decimal = table[i];
+    if (i >= 100)
+      decimal.data[decimal.size++] = char('0' + i / 100);
+    if (i >= 10)
+      decimal.data[decimal.size++] = char('0' + i / 10 % 10);
+    decimal.data[decimal.size++] = char('0' + i % 10);
+  }
+  return table;
+}
+
+constexpr std::array<Decimal, 256> decimal_table = BuildDecimalTable();
+
+void AppendDecimal(std::string& out, uint8_t value) {
+  out.append(decimal_table[value].data, decimal_table[value].size);
 }
 
+}  // namespace
+
 bool Color::operator==(const Color& rhs) const {
   return red_ == rhs.red_ && green_ == rhs.green_ && blue_ == rhs.blue_ &&
          type_ == rhs.type_;
@@ -26,23 +53,38 @@ bool Color::operator!=(const Color& rhs) const {
 }
 
 std::string Color::Print(bool is_background_color) const {
+  std::string out;
+  Print(is_background_color, out);
+  return out;
+}
+
+/// @brief Append the SGR parameters selecting this color to |out|.
+/// @param is_background_color Whether this is a background or foreground color.
+/// @param out The string to append to.
+void Color::Print(bool is_background_color, std::string& out) const {
   switch (type_) {
     case ColorType::Palette1:
-      return is_background_color ? "49" : "39";
+      out += is_background_color ? "49" : "39";
+      return;
 
     case ColorType::Palette16:
-      return palette16code[index_][is_background_color];
+      out += palette16code[index_][is_background_color];
+      return;
 
     case ColorType::Palette256:
-      return (is_background_color ? "48;5;" : "38;5;") + std::to_string(index_);
+      out += is_background_color ? "48;5;" : "38;5;";
+      AppendDecimal(out, index_);
+      return;
 
     case ColorType::TrueColor:
-      return (is_background_color ? "48;2;" : "38;2;")  //
-             + std::to_string(red_) + ";"               //
-             + std::to_string(green_) + ";"             //
-             + std::to_string(blue_);                   //
+      out += is_background_color ? "48;2;" : "38;2;";
+      AppendDecimal(out, red_);
+      out += ';';
+      AppendDecimal(out, green_);
+      out += ';';
+      AppendDecimal(out, blue_);
+      return;
   }
-  return "";
 }
 
 /// @brief Build a transparent color.
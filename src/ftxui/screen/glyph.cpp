@@ -0,0 +1,187 @@
+#include "ftxui/screen/glyph.hpp"
+
+#include <stddef.h>       // for size_t
+#include <algorithm>      // for max, min
+#include <atomic>         // for atomic, memory_order_acquire
+#include <mutex>          // for mutex, lock_guard
+#include <ostream>        // for ostream
+#include <unordered_map>  // for unordered_map
+
+#include "ftxui/screen/string.hpp"  // for string_width
+
+namespace ftxui {
+
+namespace {
+
+// Decode |input| when it is the canonical UTF8 representation of exactly one
+// codepoint. Re-encoding the codepoint must give back |input|.
+bool DecodeCodepoint(const std::string& input, uint32_t* codepoint) {
+  if (input.empty() || input.size() > 4)
+    return false;
+
+  const uint8_t head = input[0];
+  size_t size = 0;
+  uint32_t value = 0;
+  if ((head & 0b1000'0000) == 0b0000'0000) {
+    size = 1;
+    value = head;
+  } else if ((head & 0b1110'0000) == 0b1100'0000) {
+    size = 2;
+    value = head & 0b0001'1111;
+  } else if ((head & 0b1111'0000) == 0b1110'0000) {
+    size = 3;
+    value = head & 0b0000'1111;
+  } else if ((head & 0b1111'1000) == 0b1111'0000) {
+    size = 4;
+    value = head & 0b0000'0111;
+  } else {
+    return false;
+  }
+
+  if (input.size() != size)
+    return false;
+
+  for (size_t i = 1; i < size; ++i) {
+    const uint8_t byte = input[i];
+    if ((byte & 0b1100'0000) != 0b1000'0000)
+      return false;
+    value = (value << 6) | (byte & 0b0011'1111);
+  }
+
+  // Reject overlong encodings, surrogates and values out of the unicode range.
+  static const uint32_t minimum[] = {0, 0, 0x80, 0x800, 0x10000};
+  if (value < minimum[size] || value > 0x10FFFF ||
+      (value >= 0xD800 && value <= 0xDFFF)) {
+    return false;
+  }
+
+  *codepoint = value;
+  return true;
+}
+
+// Write the UTF8 representation of |codepoint| into |out|. Returns the number
+// of bytes written.
+size_t EncodeCodepoint(uint32_t codepoint, char* out) {
+  if (codepoint < 0x80) {
+    out[0] = char(codepoint);
+    return 1;
+  }
+  if (codepoint < 0x800) {
+    out[0] = char(0b1100'0000 | (codepoint >> 6));
+    out[1] = char(0b1000'0000 | (codepoint & 0b0011'1111));
+    return 2;
+  }
+  if (codepoint < 0x10000) {
+    out[0] = char(0b1110'0000 | (codepoint >> 12));
+    out[1] = char(0b1000'0000 | ((codepoint >> 6) & 0b0011'1111));
+    out[2] = char(0b1000'0000 | (codepoint & 0b0011'1111));
+    return 3;
+  }
+  out[0] = char(0b1111'0000 | (codepoint >> 18));
+  out[1] = char(0b1000'0000 | ((codepoint >> 12) & 0b0011'1111));
+  out[2] = char(0b1000'0000 | ((codepoint >> 6) & 0b0011'1111));
+  out[3] = char(0b1000'0000 | (codepoint & 0b0011'1111));
+  return 4;
+}
+
+// The glyphs not representable by a single codepoint. The table only grows:
+// a cluster keeps its identifier until the program exits. It holds at most
+// kChunkSize * kMaxChunks clusters (about one million). The next ones are
+// displayed as U+FFFD.
+//
+// Interning takes the mutex. Reading a cluster, done for every frame, doesn't:
+// the clusters are stored in chunks never moved, and never modified once
+// their identifier is given.
+constexpr size_t kChunkSize = 1024;
+constexpr size_t kMaxChunks = 1024;
+constexpr uint32_t kReplacementCharacter = 0xFFFD;
+
+struct ClusterTable {
+  ClusterTable() {
+    for (auto& chunk : chunks)
+      chunk.store(nullptr, std::memory_order_relaxed);
+  }
+  ~ClusterTable() {
+    for (auto& chunk : chunks)
+      delete[] chunk.load(std::memory_order_relaxed);
+  }
+
+  std::mutex mutex;
+  // Guarded by |mutex|:
+  std::unordered_map<std::string, uint32_t> ids;
+  size_t size = 0;
+
+  std::atomic<std::string*> chunks[kMaxChunks];
+};
+
+ClusterTable& GetClusterTable() {
+  static ClusterTable table;
+  return table;
+}
+
+}  // namespace
+
+void Glyph::Intern(const std::string& value) {
+  width_ = std::min(std::max(string_width(value), 0), 3);
+
+  uint32_t codepoint = 0;
+  if (DecodeCodepoint(value, &codepoint)) {
+    id_ = codepoint;
+    return;
+  }
+
+  ClusterTable& table = GetClusterTable();
+  std::lock_guard<std::mutex> lock(table.mutex);
+  auto it = table.ids.find(value);
+  if (it != table.ids.end()) {
+    id_ = it->second;
+    return;
+  }
+  if (table.size == kChunkSize * kMaxChunks) {
+    id_ = kReplacementCharacter;
+    return;
+  }
+
+  const size_t index = table.size++;
+  std::atomic<std::string*>& chunk = table.chunks[index / kChunkSize];
+  std::string* clusters = chunk.load(std::memory_order_relaxed);
+  if (!clusters)
+    clusters = new std::string[kChunkSize];
+  clusters[index % kChunkSize] = value;
+  chunk.store(clusters, std::memory_order_release);
+
+  id_ = kFirstClusterId + uint32_t(index);
+  table.ids[value] = id_;
+}
+
+/// @brief Append the UTF8 representation of the glyph to |out|.
+void Glyph::AppendTo(std::string& out) const {
+  if (id_ < kFirstClusterId) {
+    char buffer[4];
+    out.append(buffer, EncodeCodepoint(id_, buffer));
+    return;
+  }
+
+  const size_t index = id_ - kFirstClusterId;
+  const std::string* clusters =
+      GetClusterTable().chunks[index / kChunkSize].load(
+          std::memory_order_acquire);
+  out += clusters[index % kChunkSize];
+}
+
+/// @brief The UTF8 representation of the glyph.
+Glyph::operator std::string() const {
+  std::string out;
+  AppendTo(out);
+  return out;
+}
+
+std::ostream& operator<<(std::ostream& out, const Glyph& glyph) {
+  return out << std::string(glyph);
+}
+
+}  // namespace ftxui
+
+// Copyright 2021 Arthur Sonzogni. All rights reserved.
+// Use of this source code is governed by the MIT license that can be found in
+// the LICENSE file.
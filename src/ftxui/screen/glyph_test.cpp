@@ -0,0 +1,82 @@
+#include <gtest/gtest-message.h>  // for Message
+#include <gtest/gtest-test-part.h>  // for TestPartResult, SuiteApiResolver, TestFactoryImpl
+#include <string>                   // for allocator, string, to_string
+#include <thread>                   // for thread
+#include <vector>                   // for vector
+
+#include "ftxui/screen/glyph.hpp"
+#include "gtest/gtest_pred_impl.h"  // for EXPECT_EQ, Test, TEST
+
+using namespace ftxui;
+
+TEST(GlyphTest, Default) {
+  Glyph glyph;
+  EXPECT_EQ(" ", std::string(glyph));
+  EXPECT_EQ(1, glyph.width());
+}
+
+TEST(GlyphTest, Codepoint) {
+  EXPECT_EQ(uint32_t('a'), Glyph("a").id());
+  EXPECT_EQ(0x2500u, Glyph("─").id());
+  EXPECT_EQ(0x6D4Bu, Glyph("测").id());
+  EXPECT_EQ(0x1F600u, Glyph("😀").id());
+
+  EXPECT_EQ("─", std::string(Glyph("─")));
+  EXPECT_EQ("😀", std::string(Glyph("😀")));
+}
+
+TEST(GlyphTest, Width) {
+  EXPECT_EQ(1, Glyph("a").width());
+  EXPECT_EQ(1, Glyph("─").width());
+  EXPECT_EQ(2, Glyph("测").width());
+  EXPECT_EQ(1, Glyph("a⃒").width());
+  EXPECT_EQ(0, Glyph("").width());
+}
+
+TEST(GlyphTest, Cluster) {
+  Glyph a = "a⃒";
+  Glyph b = std::string("a⃒");
+  EXPECT_GE(a.id(), Glyph::kFirstClusterId);
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, Glyph("a"));
+  EXPECT_EQ("a⃒", std::string(a));
+
+  // The empty string and invalid UTF8 are kept as is.
+  EXPECT_EQ("", std::string(Glyph("")));
+  EXPECT_EQ("\xFF", std::string(Glyph("\xFF")));
+}
+
+TEST(GlyphTest, ClustersFromSeveralThreads) {
+  // The clusters are read while others are interned, across several chunks.
+  const Glyph first = "a⃒";
+  std::thread reader([&] {
+    for (int i = 0; i < 10000; ++i)
+      EXPECT_EQ("a⃒", std::string(first));
+  });
+  std::vector<Glyph> glyphs;
+  for (int i = 0; i < 3000; ++i)
+    glyphs.push_back(Glyph("cluster" + std::to_string(i)));
+  reader.join();
+
+  for (int i = 0; i < 3000; ++i)
+    EXPECT_EQ("cluster" + std::to_string(i), std::string(glyphs[i]));
+}
+
+TEST(GlyphTest, Assignment) {
+  Glyph glyph;
+  glyph = "b";
+  EXPECT_EQ(glyph, "b");
+  glyph = std::string("测");
+  EXPECT_EQ(glyph, "测");
+  EXPECT_EQ(2, glyph.width());
+}
+
+TEST(GlyphTest, FromCodepoint) {
+  const Glyph glyph = Glyph::FromCodepoint(0x2500, 1);
+  EXPECT_EQ(glyph, "─");
+  EXPECT_EQ(1, glyph.width());
+}
+
+// Copyright 2021 Arthur Sonzogni. All rights reserved.
+// Use of this source code is governed by the MIT license that can be found in
+// the LICENSE file.
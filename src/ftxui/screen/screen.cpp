@@ -1,11 +1,12 @@
-#include <iostream>  // for operator<<, stringstream, basic_ostream, flush, cout, ostream
-#include <map>      // for _Rb_tree_const_iterator, map, operator!=, operator==
-#include <memory>   // for allocator, allocator_traits<>::value_type
-#include <sstream>  // IWYU pragma: keep
-#include <utility>  // for pair
+#include <stdint.h>   // for uint8_t, uint32_t
+#include <algorithm>  // for fill, copy, copy_backward, max, min
+#include <charconv>   // for to_chars
+#include <cstdlib>    // for abs
+#include <cstring>    // for memcpy
+#include <iostream>  // for operator<<, basic_ostream, flush, cout, ostream
+#include <memory>    // for allocator, allocator_traits<>::value_type
 
 #include "ftxui/screen/screen.hpp"
-#include "ftxui/screen/string.hpp"    // for string_width
 #include "ftxui/screen/terminal.hpp"  // for Dimensions, Size
 
 #if defined(_WIN32)
@@ -19,25 +20,34 @@
 namespace ftxui {
 
 namespace {
-static const char BOLD_SET[] = "\x1B[1m";
-static const char BOLD_RESET[] = "\x1B[22m";  // Can't use 21 here.
+// SGR (Select Graphic Rendition) parameters:
+static const char BOLD_SET[] = "1";
+static const char BOLD_RESET[] = "22";  // Can't use 21 here.
 
-static const char DIM_SET[] = "\x1B[2m";
-static const char DIM_RESET[] = "\x1B[22m";
+static const char DIM_SET[] = "2";
+static const char DIM_RESET[] = "22";  // Shared with BOLD_RESET.
 
-static const char UNDERLINED_SET[] = "\x1B[4m";
-static const char UNDERLINED_RESET[] = "\x1B[24m";
+static const char UNDERLINED_SET[] = "4";
+static const char UNDERLINED_RESET[] = "24";
 
-static const char BLINK_SET[] = "\x1B[5m";
-static const char BLINK_RESET[] = "\x1B[25m";
+static const char BLINK_SET[] = "5";
+static const char BLINK_RESET[] = "25";
 
-static const char INVERTED_SET[] = "\x1B[7m";
-static const char INVERTED_RESET[] = "\x1B[27m";
+static const char INVERTED_SET[] = "7";
+static const char INVERTED_RESET[] = "27";
 
 static const char MOVE_LEFT[] = "\r";
 static const char MOVE_UP[] = "\x1B[1A";
 static const char CLEAR_LINE[] = "\x1B[2K";
 
+// Reprinting a few unmodified cells is cheaper than moving the cursor over
+// them.
+constexpr int kMaxReprintedCells = 4;
+
+// Scrolling the terminal costs ~15 bytes. This is worth it as soon as a single
+// row doesn't have to be reprinted.
+constexpr int kMinScrolledRows = 1;
+
 Pixel dev_null_pixel;
 
 #if defined(_WIN32)
@@ -63,257 +73,559 @@ void WindowsEmulateVT100Terminal() {
 }
 #endif
 
-void UpdatePixelStyle(std::stringstream& ss,
-                      Pixel& previous,
-                      const Pixel& next) {
-  if (next.bold != previous.bold)
-    ss << (next.bold ? BOLD_SET : BOLD_RESET);
+void AppendNumber(std::string& out, int value) {
+  char buffer[16];
+  const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  out.append(buffer, result.ptr);
+}
 
-  if (next.dim != previous.dim)
-    ss << (next.dim ? DIM_SET : DIM_RESET);
+bool SameStyle(const Pixel& a, const Pixel& b) {
+  return a.background_color == b.background_color &&  //
+         a.foreground_color == b.foreground_color &&  //
+         a.blink == b.blink &&                        //
+         a.bold == b.bold &&                          //
+         a.dim == b.dim &&                            //
+         a.inverted == b.inverted &&                  //
+         a.underlined == b.underlined;                //
+}
+
+bool IsAscii(const Glyph& glyph) {
+  return glyph.id() < 0x80;
+}
+
+bool SamePixel(const Pixel& a, const Pixel& b) {
+  return a.character == b.character && SameStyle(a, b);
+}
+
+bool SameRow(const Pixel* a, const Pixel* b, int size) {
+  for (int x = 0; x < size; ++x) {
+    if (!SamePixel(a[x], b[x]))
+      return false;
+  }
+  return true;
+}
+
+// FNV-1a, consuming 32 bits at a time.
+void HashPixel(uint64_t& hash, const Pixel& pixel) {
+  static_assert(sizeof(Color) == sizeof(uint32_t), "Color is hashed as 32 bit");
+  uint32_t background = 0;
+  uint32_t foreground = 0;
+  std::memcpy(&background, &pixel.background_color, sizeof(uint32_t));
+  std::memcpy(&foreground, &pixel.foreground_color, sizeof(uint32_t));
+  const uint32_t style = pixel.blink << 0 | pixel.bold << 1 | pixel.dim << 2 |
+                         pixel.inverted << 3 | pixel.underlined << 4;
+  for (uint32_t value : {pixel.character.id(), background, foreground, style})
+    hash = (hash ^ value) * 0x100000001b3;
+}
+
+uint64_t HashRow(const Pixel* row, int size) {
+  uint64_t hash = 0xcbf29ce484222325;
+  for (int x = 0; x < size; ++x)
+    HashPixel(hash, row[x]);
+  return hash;
+}
+
+uint64_t HashBlankRow(int size) {
+  const Pixel blank;
+  uint64_t hash = 0xcbf29ce484222325;
+  for (int x = 0; x < size; ++x)
+    HashPixel(hash, blank);
+  return hash;
+}
+
+// Append to |out| the single "CSI ... m" sequence transforming the style of
+// |previous| into the style of |next|. Only the modified parameters are
+// written.
+void UpdatePixelStyle(std::string& out, Pixel& previous, const Pixel& next) {
+  if (SameStyle(previous, next))
+    return;
+
+  out += "\x1B[";
+  auto add = [&](const char* parameter) {
+    out += parameter;
+    out += ';';
+  };
+
+  // Bold and dim are reset together.
+  bool bold = previous.bold;
+  bool dim = previous.dim;
+  if ((bold && !next.bold) || (dim && !next.dim)) {
+    add(BOLD_RESET);
+    bold = false;
+    dim = false;
+  }
+  if (next.bold && !bold)
+    add(BOLD_SET);
+  if (next.dim && !dim)
+    add(DIM_SET);
 
   if (next.underlined != previous.underlined)
-    ss << (next.underlined ? UNDERLINED_SET : UNDERLINED_RESET);
+    add(next.underlined ? UNDERLINED_SET : UNDERLINED_RESET);
 
   if (next.blink != previous.blink)
-    ss << (next.blink ? BLINK_SET : BLINK_RESET);
+    add(next.blink ? BLINK_SET : BLINK_RESET);
 
   if (next.inverted != previous.inverted)
-    ss << (next.inverted ? INVERTED_SET : INVERTED_RESET);
+    add(next.inverted ? INVERTED_SET : INVERTED_RESET);
+
+  if (next.foreground_color != previous.foreground_color) {
+    next.foreground_color.Print(false, out);
+    out += ';';
+  }
 
-  if (next.foreground_color != previous.foreground_color ||
-      next.background_color != previous.background_color) {
-    ss << "\x1B[" + next.foreground_color.Print(false) + "m";
-    ss << "\x1B[" + next.background_color.Print(true) + "m";
+  if (next.background_color != previous.background_color) {
+    next.background_color.Print(true, out);
+    out += ';';
   }
 
+  // Replace the trailing separator.
+  out.back() = 'm';
+
   previous = next;
 }
 
-struct TileEncoding {
-  unsigned int left : 2;
-  unsigned int top : 2;
-  unsigned int right : 2;
-  unsigned int down : 2;
-  unsigned int round : 1;
-
-  // clang-format off
-  bool operator<(const TileEncoding& other) const {
-    if (left < other.left) return true;
-    if (left > other.left) return false;
-    if (top < other.top) return true;
-    if (top > other.top) return false;
-    if (right < other.right) return true;
-    if (right > other.right) return false;
-    if (down < other.down) return true;
-    if (down > other.down) return false;
-    if (round < other.round) return true;
-    if (round > other.round) return false;
-      return false;
+// Move the cursor from (|cursor_x|, |cursor_y|) to (|x|, |y|). The rows are
+// reached using relative moves (CUU/CUD), because the screen isn't necessarily
+// drawn at the top of the terminal. The columns are reached using absolute
+// moves (CHA). A negative |cursor_x| means the column is unknown.
+void MoveCursor(std::string& out,
+                int& cursor_x,
+                int& cursor_y,
+                int x,
+                int y) {
+  if (y > cursor_y) {
+    out += "\x1B[";
+    AppendNumber(out, y - cursor_y);
+    out += 'B';
+  }
+  if (y < cursor_y) {
+    out += "\x1B[";
+    AppendNumber(out, cursor_y - y);
+    out += 'A';
+  }
+  if (x != cursor_x) {
+    if (x == 0) {
+      out += MOVE_LEFT;
+    } else {
+      out += "\x1B[";
+      AppendNumber(out, x + 1);
+      out += 'G';
+    }
+  }
+  cursor_x = x;
+  cursor_y = y;
+}
+
+// The DEC special graphics character drawing the same glyph, or zero.
+// clang-format off
+char DecSpecialGraphics(const Glyph& glyph) {
+  switch (glyph.id()) {
+    case 0x2500: return 'q';  // ─
+    case 0x2502: return 'x';  // │
+    case 0x250C: return 'l';  // ┌
+    case 0x2510: return 'k';  // ┐
+    case 0x2514: return 'm';  // └
+    case 0x2518: return 'j';  // ┘
+    case 0x251C: return 't';  // ├
+    case 0x2524: return 'u';  // ┤
+    case 0x252C: return 'w';  // ┬
+    case 0x2534: return 'v';  // ┴
+    case 0x253C: return 'n';  // ┼
+    default: return 0;
   }
-  // clang-format on
+}
+// clang-format on
+
+// Erasing a space keeps only its background color.
+bool IsErasable(const Pixel& pixel) {
+  return pixel.character.id() == ' ' && !pixel.inverted && !pixel.underlined;
+}
+
+int DecimalSize(int value) {
+  int size = 1;
+  for (; value >= 10; value /= 10)
+    ++size;
+  return size;
+}
+
+// Append the pixels to |out|, using the encoding selected by the
+// Screen::OutputMode. Consecutive calls to Print() must target adjacent cells,
+// until Flush() is called.
+class PixelWriter {
+ public:
+  PixelWriter(std::string& out, Screen::OutputMode mode)
+      : out_(out), mode_(mode) {}
+
+  void Print(const Pixel& pixel) {
+    if (!mode_.compress) {
+      Write(pixel);
+      return;
+    }
+
+    // Identical pixels are accumulated, until a different one is printed.
+    if (pending_ != 0 && SamePixel(pixel, pending_pixel_)) {
+      ++pending_;
+      return;
+    }
+    Flush(/*end_of_row=*/false);
+    pending_pixel_ = pixel;
+    pending_ = 1;
+  }
+
+  // Print a run of ASCII characters sharing the same style.
+  void PrintAscii(const Pixel* begin, const Pixel* end) {
+    UpdatePixelStyle(out_, style_, *begin);
+    const size_t size = out_.size();
+    out_.resize(size + (end - begin));
+    for (char* data = &out_[size]; begin != end; ++begin, ++data)
+      *data = static_cast<char>(begin->character.id());
+  }
+
+  // Write the accumulated pixels. At the |end_of_row|, blank pixels can be
+  // erased instead. Returns the number of cells erased, the cursor is left
+  // before them.
+  int Flush(bool end_of_row) {
+    const int count = pending_;
+    if (count == 0)
+      return 0;
+    pending_ = 0;
+
+    // ECH: Erase characters.
+    if (end_of_row && IsErasable(pending_pixel_) &&
+        3 + DecimalSize(count) < count) {
+      UpdatePixelStyle(out_, style_, pending_pixel_);
+      out_ += "\x1B[";
+      AppendNumber(out_, count);
+      out_ += 'X';
+      return count;
+    }
+
+    const size_t size = Write(pending_pixel_);
+    const int repeat = count - 1;
+    if (repeat == 0)
+      return 0;
+
+    // REP: Repeat the preceding character. This only repeats the last
+    // codepoint of grapheme clusters.
+    const int width = pending_pixel_.character.width();
+    if (pending_pixel_.character.id() < Glyph::kFirstClusterId &&
+        (width == 1 || width == 2) &&
+        3 + DecimalSize(repeat) < int(size) * repeat) {
+      out_ += "\x1B[";
+      AppendNumber(out_, repeat);
+      out_ += 'b';
+      return 0;
+    }
+
+    for (int i = 0; i < repeat; ++i)
+      WriteGlyph(pending_pixel_.character);
+    return 0;
+  }
+
+  // Go back to the default style. Flush() must be called before.
+  void ResetStyle() { UpdatePixelStyle(out_, style_, Pixel()); }
+
+  // Go back to the default style and character set. Flush() must be called
+  // before.
+  void Reset() {
+    ResetStyle();
+    SetSpecialGraphics(false);
+  }
+
+ private:
+  // Returns the size of the glyph, in bytes.
+  size_t Write(const Pixel& pixel) {
+    UpdatePixelStyle(out_, style_, pixel);
+    return WriteGlyph(pixel.character);
+  }
+
+  size_t WriteGlyph(const Glyph& glyph) {
+    const char special = mode_.dec_special_graphics ? DecSpecialGraphics(glyph)
+                                                    : 0;
+    SetSpecialGraphics(special != 0);
+    if (special) {
+      out_ += special;
+      return 1;
+    }
+    const size_t size = out_.size();
+    glyph.AppendTo(out_);
+    return out_.size() - size;
+  }
+
+  void SetSpecialGraphics(bool enabled) {
+    if (special_graphics_ == enabled)
+      return;
+    special_graphics_ = enabled;
+    // SCS: Designate the G0 character set.
+    out_ += enabled ? "\x1B(0" : "\x1B(B";
+  }
+
+  std::string& out_;
+  const Screen::OutputMode mode_;
+  Pixel style_;
+  bool special_graphics_ = false;
+  Pixel pending_pixel_;
+  int pending_ = 0;
+};
+
+// The line drawn by a box drawing character in each direction:
+// 0: none, 1: light, 2: heavy, 3: double. |round| is set for the arcs.
+struct TileEncoding {
+  uint8_t left : 2;
+  uint8_t top : 2;
+  uint8_t right : 2;
+  uint8_t down : 2;
+  uint8_t round : 1;
+};
+
+struct Tile {
+  char32_t codepoint;
+  TileEncoding encoding;
 };
 
 // clang-format off
-const std::map<std::string, TileEncoding> tile_encoding = {
-    {"─", {1, 0, 1, 0, 0}},
-    {"━", {2, 0, 2, 0, 0}},
-
-    {"│", {0, 1, 0, 1, 0}},
-    {"┃", {0, 2, 0, 2, 0}},
-
-    {"┌", {0, 0, 1, 1, 0}},
-    {"┍", {0, 0, 2, 1, 0}},
-    {"┎", {0, 0, 1, 2, 0}},
-    {"┏", {0, 0, 2, 2, 0}},
-
-    {"┐", {1, 0, 0, 1, 0}},
-    {"┑", {2, 0, 0, 1, 0}},
-    {"┒", {1, 0, 0, 2, 0}},
-    {"┓", {2, 0, 0, 2, 0}},
-
-    {"└", {0, 1, 1, 0, 0}},
-    {"┕", {0, 1, 2, 0, 0}},
-    {"┖", {0, 2, 1, 0, 0}},
-    {"┗", {0, 2, 2, 0, 0}},
-
-    {"┘", {1, 1, 0, 0, 0}},
-    {"┙", {2, 1, 0, 0, 0}},
-    {"┚", {1, 2, 0, 0, 0}},
-    {"┛", {2, 2, 0, 0, 0}},
-
-    {"├", {0, 1, 1, 1, 0}},
-    {"┝", {0, 1, 2, 1, 0}},
-    {"┞", {0, 2, 1, 1, 0}},
-    {"┟", {0, 1, 1, 2, 0}},
-    {"┠", {0, 2, 1, 2, 0}},
-    {"┡", {0, 2, 2, 1, 0}},
-    {"┢", {0, 1, 2, 2, 0}},
-    {"┣", {0, 2, 2, 2, 0}},
-
-    {"┤", {1, 1, 0, 1, 0}},
-    {"┥", {2, 1, 0, 1, 0}},
-    {"┦", {1, 2, 0, 1, 0}},
-    {"┧", {1, 1, 0, 2, 0}},
-    {"┨", {1, 2, 0, 2, 0}},
-    {"┩", {2, 2, 0, 1, 0}},
-    {"┪", {2, 1, 0, 2, 0}},
-    {"┫", {2, 2, 0, 2, 0}},
-
-    {"┬", {1, 0, 1, 1, 0}},
-    {"┭", {2, 0, 1, 1, 0}},
-    {"┮", {1, 0, 2, 1, 0}},
-    {"┯", {2, 0, 2, 1, 0}},
-    {"┰", {1, 0, 1, 2, 0}},
-    {"┱", {2, 0, 1, 2, 0}},
-    {"┲", {1, 0, 2, 2, 0}},
-    {"┳", {2, 0, 2, 2, 0}},
-
-    {"┴", {1, 1, 1, 0, 0}},
-    {"┵", {2, 1, 1, 0, 0}},
-    {"┶", {1, 1, 2, 0, 0}},
-    {"┷", {2, 1, 2, 0, 0}},
-    {"┸", {1, 2, 1, 0, 0}},
-    {"┹", {2, 2, 1, 0, 0}},
-    {"┺", {1, 2, 2, 0, 0}},
-    {"┻", {2, 2, 2, 0, 0}},
-
-    {"┼", {1, 1, 1, 1, 0}},
-    {"┽", {2, 1, 1, 1, 0}},
-    {"┾", {1, 1, 2, 1, 0}},
-    {"┿", {2, 1, 2, 1, 0}},
-    {"╀", {1, 2, 1, 1, 0}},
-    {"╁", {1, 1, 1, 2, 0}},
-    {"╂", {1, 2, 1, 2, 0}},
-    {"╃", {2, 2, 1, 1, 0}},
-    {"╄", {1, 2, 2, 1, 0}},
-    {"╅", {2, 1, 1, 2, 0}},
-    {"╆", {1, 1, 2, 2, 0}},
-    {"╇", {2, 2, 2, 1, 0}},
-    {"╈", {2, 1, 2, 2, 0}},
-    {"╉", {2, 2, 1, 2, 0}},
-    {"╊", {1, 2, 2, 2, 0}},
-    {"╋", {2, 2, 2, 2, 0}},
-
-    {"═", {3, 0, 3, 0, 0}},
-    {"║", {0, 3, 0, 3, 0}},
-
-    {"╒", {0, 0, 3, 1, 0}},
-    {"╓", {0, 0, 1, 3, 0}},
-    {"╔", {0, 0, 3, 3, 0}},
-
-    {"╕", {3, 0, 0, 1, 0}},
-    {"╖", {1, 0, 0, 3, 0}},
-    {"╗", {3, 0, 0, 3, 0}},
-
-    {"╘", {0, 1, 3, 0, 0}},
-    {"╙", {0, 3, 1, 0, 0}},
-    {"╚", {0, 3, 3, 0, 0}},
-
-    {"╛", {3, 1, 0, 0, 0}},
-    {"╜", {1, 3, 0, 0, 0}},
-    {"╝", {3, 3, 0, 0, 0}},
-
-    {"╞", {0, 1, 3, 1, 0}},
-    {"╟", {0, 3, 1, 3, 0}},
-    {"╠", {0, 3, 3, 3, 0}},
-
-    {"╡", {3, 1, 0, 1, 0}},
-    {"╢", {1, 3, 0, 3, 0}},
-    {"╣", {3, 3, 0, 3, 0}},
-
-    {"╤", {3, 0, 3, 1, 0}},
-    {"╥", {1, 0, 1, 3, 0}},
-    {"╦", {3, 0, 3, 3, 0}},
-
-    {"╧", {3, 1, 3, 0, 0}},
-    {"╨", {1, 3, 1, 0, 0}},
-    {"╩", {3, 3, 3, 0, 0}},
-
-    {"╪", {3, 1, 3, 1, 0}},
-    {"╫", {1, 3, 1, 3, 0}},
-    {"╬", {3, 3, 3, 3, 0}},
-
-    {"╭", {0, 0, 1, 1, 1}},
-    {"╮", {1, 0, 0, 1, 1}},
-    {"╯", {1, 1, 0, 0, 1}},
-    {"╰", {0, 1, 1, 0, 1}},
-
-    {"╴", {1, 0, 0, 0, 0}},
-    {"╵", {0, 1, 0, 0, 0}},
-    {"╶", {0, 0, 1, 0, 0}},
-    {"╷", {0, 0, 0, 1, 0}},
-
-    {"╸", {2, 0, 0, 0, 0}},
-    {"╹", {0, 2, 0, 0, 0}},
-    {"╺", {0, 0, 2, 0, 0}},
-    {"╻", {0, 0, 0, 2, 0}},
-
-    {"╼", {1, 0, 2, 0, 0}},
-    {"╽", {0, 1, 0, 2, 0}},
-    {"╾", {2, 0, 1, 0, 0}},
-    {"╿", {0, 2, 0, 1, 0}},
+constexpr Tile tiles[] = {
+    {U'─', {1, 0, 1, 0, 0}},
+    {U'━', {2, 0, 2, 0, 0}},
+
+    {U'│', {0, 1, 0, 1, 0}},
+    {U'┃', {0, 2, 0, 2, 0}},
+
+    {U'┌', {0, 0, 1, 1, 0}},
+    {U'┍', {0, 0, 2, 1, 0}},
+    {U'┎', {0, 0, 1, 2, 0}},
+    {U'┏', {0, 0, 2, 2, 0}},
+
+    {U'┐', {1, 0, 0, 1, 0}},
+    {U'┑', {2, 0, 0, 1, 0}},
+    {U'┒', {1, 0, 0, 2, 0}},
+    {U'┓', {2, 0, 0, 2, 0}},
+
+    {U'└', {0, 1, 1, 0, 0}},
+    {U'┕', {0, 1, 2, 0, 0}},
+    {U'┖', {0, 2, 1, 0, 0}},
+    {U'┗', {0, 2, 2, 0, 0}},
+
+    {U'┘', {1, 1, 0, 0, 0}},
+    {U'┙', {2, 1, 0, 0, 0}},
+    {U'┚', {1, 2, 0, 0, 0}},
+    {U'┛', {2, 2, 0, 0, 0}},
+
+    {U'├', {0, 1, 1, 1, 0}},
+    {U'┝', {0, 1, 2, 1, 0}},
+    {U'┞', {0, 2, 1, 1, 0}},
+    {U'┟', {0, 1, 1, 2, 0}},
+    {U'┠', {0, 2, 1, 2, 0}},
+    {U'┡', {0, 2, 2, 1, 0}},
+    {U'┢', {0, 1, 2, 2, 0}},
+    {U'┣', {0, 2, 2, 2, 0}},
+
+    {U'┤', {1, 1, 0, 1, 0}},
+    {U'┥', {2, 1, 0, 1, 0}},
+    {U'┦', {1, 2, 0, 1, 0}},
+    {U'┧', {1, 1, 0, 2, 0}},
+    {U'┨', {1, 2, 0, 2, 0}},
+    {U'┩', {2, 2, 0, 1, 0}},
+    {U'┪', {2, 1, 0, 2, 0}},
+    {U'┫', {2, 2, 0, 2, 0}},
+
+    {U'┬', {1, 0, 1, 1, 0}},
+    {U'┭', {2, 0, 1, 1, 0}},
+    {U'┮', {1, 0, 2, 1, 0}},
+    {U'┯', {2, 0, 2, 1, 0}},
+    {U'┰', {1, 0, 1, 2, 0}},
+    {U'┱', {2, 0, 1, 2, 0}},
+    {U'┲', {1, 0, 2, 2, 0}},
+    {U'┳', {2, 0, 2, 2, 0}},
+
+    {U'┴', {1, 1, 1, 0, 0}},
+    {U'┵', {2, 1, 1, 0, 0}},
+    {U'┶', {1, 1, 2, 0, 0}},
+    {U'┷', {2, 1, 2, 0, 0}},
+    {U'┸', {1, 2, 1, 0, 0}},
+    {U'┹', {2, 2, 1, 0, 0}},
+    {U'┺', {1, 2, 2, 0, 0}},
+    {U'┻', {2, 2, 2, 0, 0}},
+
+    {U'┼', {1, 1, 1, 1, 0}},
+    {U'┽', {2, 1, 1, 1, 0}},
+    {U'┾', {1, 1, 2, 1, 0}},
+    {U'┿', {2, 1, 2, 1, 0}},
+    {U'╀', {1, 2, 1, 1, 0}},
+    {U'╁', {1, 1, 1, 2, 0}},
+    {U'╂', {1, 2, 1, 2, 0}},
+    {U'╃', {2, 2, 1, 1, 0}},
+    {U'╄', {1, 2, 2, 1, 0}},
+    {U'╅', {2, 1, 1, 2, 0}},
+    {U'╆', {1, 1, 2, 2, 0}},
+    {U'╇', {2, 2, 2, 1, 0}},
+    {U'╈', {2, 1, 2, 2, 0}},
+    {U'╉', {2, 2, 1, 2, 0}},
+    {U'╊', {1, 2, 2, 2, 0}},
+    {U'╋', {2, 2, 2, 2, 0}},
+
+    {U'═', {3, 0, 3, 0, 0}},
+    {U'║', {0, 3, 0, 3, 0}},
+
+    {U'╒', {0, 0, 3, 1, 0}},
+    {U'╓', {0, 0, 1, 3, 0}},
+    {U'╔', {0, 0, 3, 3, 0}},
+
+    {U'╕', {3, 0, 0, 1, 0}},
+    {U'╖', {1, 0, 0, 3, 0}},
+    {U'╗', {3, 0, 0, 3, 0}},
+
+    {U'╘', {0, 1, 3, 0, 0}},
+    {U'╙', {0, 3, 1, 0, 0}},
+    {U'╚', {0, 3, 3, 0, 0}},
+
+    {U'╛', {3, 1, 0, 0, 0}},
+    {U'╜', {1, 3, 0, 0, 0}},
+    {U'╝', {3, 3, 0, 0, 0}},
+
+    {U'╞', {0, 1, 3, 1, 0}},
+    {U'╟', {0, 3, 1, 3, 0}},
+    {U'╠', {0, 3, 3, 3, 0}},
+
+    {U'╡', {3, 1, 0, 1, 0}},
+    {U'╢', {1, 3, 0, 3, 0}},
+    {U'╣', {3, 3, 0, 3, 0}},
+
+    {U'╤', {3, 0, 3, 1, 0}},
+    {U'╥', {1, 0, 1, 3, 0}},
+    {U'╦', {3, 0, 3, 3, 0}},
+
+    {U'╧', {3, 1, 3, 0, 0}},
+    {U'╨', {1, 3, 1, 0, 0}},
+    {U'╩', {3, 3, 3, 0, 0}},
+
+    {U'╪', {3, 1, 3, 1, 0}},
+    {U'╫', {1, 3, 1, 3, 0}},
+    {U'╬', {3, 3, 3, 3, 0}},
+
+    {U'╭', {0, 0, 1, 1, 1}},
+    {U'╮', {1, 0, 0, 1, 1}},
+    {U'╯', {1, 1, 0, 0, 1}},
+    {U'╰', {0, 1, 1, 0, 1}},
+
+    {U'╴', {1, 0, 0, 0, 0}},
+    {U'╵', {0, 1, 0, 0, 0}},
+    {U'╶', {0, 0, 1, 0, 0}},
+    {U'╷', {0, 0, 0, 1, 0}},
+
+    {U'╸', {2, 0, 0, 0, 0}},
+    {U'╹', {0, 2, 0, 0, 0}},
+    {U'╺', {0, 0, 2, 0, 0}},
+    {U'╻', {0, 0, 0, 2, 0}},
+
+    {U'╼', {1, 0, 2, 0, 0}},
+    {U'╽', {0, 1, 0, 2, 0}},
+    {U'╾', {2, 0, 1, 0, 0}},
+    {U'╿', {0, 2, 0, 1, 0}},
 };
 // clang-format on
 
-template <class A, class B>
-const std::map<B, A> InvertMap(const std::map<A, B> input) {
-  std::map<B, A> output;
-  for (const auto& it : input)
-    output[it.second] = it.first;
-  return output;
+// Box drawing characters are in the range U+2500 - U+257F.
+constexpr uint32_t kBoxDrawingFirst = 0x2500;
+constexpr uint32_t kBoxDrawingSize = 0x80;
+constexpr uint8_t kNoTile = 0xFF;
+
+constexpr int TileKey(TileEncoding encoding) {
+  return encoding.left | encoding.top << 2 | encoding.right << 4 |
+         encoding.down << 6 | encoding.round << 8;
+}
+
+// Lookup tables between the box drawing characters and their encoding, built
+// at compile time.
+struct TileTables {
+  // Indexed by the offset of the codepoint in the box drawing block.
+  bool has_encoding[kBoxDrawingSize];
+  TileEncoding encoding[kBoxDrawingSize];
+  // Indexed by TileKey(). The offset of the codepoint, or kNoTile.
+  uint8_t codepoint[1 << 9];
+};
+
+constexpr TileTables BuildTileTables() {
+  TileTables tables{};
+  for (uint8_t& codepoint : tables.codepoint)
+    codepoint = kNoTile;
+  for (const Tile& tile : tiles) {
+    const uint32_t offset = tile.codepoint - kBoxDrawingFirst;
+    tables.has_encoding[offset] = true;
+    tables.encoding[offset] = tile.encoding;
+    tables.codepoint[TileKey(tile.encoding)] = uint8_t(offset);
+  }
+  return tables;
 }
 
-const std::map<TileEncoding, std::string> tile_encoding_inverse =
-    InvertMap(tile_encoding);
+constexpr TileTables tile_tables = BuildTileTables();
 
-void UpgradeLeftRight(std::string& left, std::string& right) {
-  const auto it_left = tile_encoding.find(left);
-  if (it_left == tile_encoding.end())
+bool IsBoxDrawing(const Glyph& glyph) {
+  return glyph.id() - kBoxDrawingFirst < kBoxDrawingSize;
+}
+
+// Return the encoding of a box drawing |glyph|, or nullptr.
+const TileEncoding* GetTileEncoding(const Glyph& glyph) {
+  if (!IsBoxDrawing(glyph))
+    return nullptr;
+  const uint32_t offset = glyph.id() - kBoxDrawingFirst;
+  return tile_tables.has_encoding[offset] ? &tile_tables.encoding[offset]
+                                          : nullptr;
+}
+
+// Replace |glyph| by the character drawing |encoding|, if any.
+void SetTile(Glyph& glyph, TileEncoding encoding) {
+  const uint8_t offset = tile_tables.codepoint[TileKey(encoding)];
+  if (offset != kNoTile)
+    glyph = Glyph::FromCodepoint(kBoxDrawingFirst + offset, 1);
+}
+
+void UpgradeLeftRight(Glyph& left, Glyph& right) {
+  const TileEncoding* encoding_left = GetTileEncoding(left);
+  if (!encoding_left)
     return;
-  const auto it_right = tile_encoding.find(right);
-  if (it_right == tile_encoding.end())
+  const TileEncoding* encoding_right = GetTileEncoding(right);
+  if (!encoding_right)
     return;
 
-  if (it_left->second.right == 0 && it_right->second.left != 0) {
-    TileEncoding encoding_left = it_left->second;
-    encoding_left.right = it_right->second.left;
-    const auto it_left_upgrade = tile_encoding_inverse.find(encoding_left);
-    if (it_left_upgrade != tile_encoding_inverse.end())
-      left = it_left_upgrade->second;
+  // Copies, because |left| is modified before |right|.
+  const TileEncoding old_left = *encoding_left;
+  const TileEncoding old_right = *encoding_right;
+
+  if (old_left.right == 0 && old_right.left != 0) {
+    TileEncoding upgrade = old_left;
+    upgrade.right = old_right.left;
+    SetTile(left, upgrade);
   }
 
-  if (it_right->second.left == 0 && it_left->second.right != 0) {
-    TileEncoding encoding_right = it_right->second;
-    encoding_right.left = it_left->second.right;
-    const auto it_right_upgrade = tile_encoding_inverse.find(encoding_right);
-    if (it_right_upgrade != tile_encoding_inverse.end())
-      right = it_right_upgrade->second;
+  if (old_right.left == 0 && old_left.right != 0) {
+    TileEncoding upgrade = old_right;
+    upgrade.left = old_left.right;
+    SetTile(right, upgrade);
   }
 }
 
-void UpgradeTopDown(std::string& top, std::string& down) {
-  const auto it_top = tile_encoding.find(top);
-  if (it_top == tile_encoding.end())
+void UpgradeTopDown(Glyph& top, Glyph& down) {
+  const TileEncoding* encoding_top = GetTileEncoding(top);
+  if (!encoding_top)
     return;
-  const auto it_down = tile_encoding.find(down);
-  if (it_down == tile_encoding.end())
+  const TileEncoding* encoding_down = GetTileEncoding(down);
+  if (!encoding_down)
     return;
 
-  if (it_top->second.down == 0 && it_down->second.top != 0) {
-    TileEncoding encoding_top = it_top->second;
-    encoding_top.down = it_down->second.top;
-    const auto it_top_down = tile_encoding_inverse.find(encoding_top);
-    if (it_top_down != tile_encoding_inverse.end())
-      top = it_top_down->second;
+  const TileEncoding old_top = *encoding_top;
+  const TileEncoding old_down = *encoding_down;
+
+  if (old_top.down == 0 && old_down.top != 0) {
+    TileEncoding upgrade = old_top;
+    upgrade.down = old_down.top;
+    SetTile(top, upgrade);
   }
 
-  if (it_down->second.top == 0 && it_top->second.down != 0) {
-    TileEncoding encoding_down = it_down->second;
-    encoding_down.top = it_top->second.down;
-    const auto it_down_top = tile_encoding_inverse.find(encoding_down);
-    if (it_down_top != tile_encoding_inverse.end())
-      down = it_down_top->second;
+  if (old_down.top == 0 && old_top.down != 0) {
+    TileEncoding upgrade = old_down;
+    upgrade.top = old_top.down;
+    SetTile(down, upgrade);
   }
 }
 
@@ -349,7 +661,7 @@ Screen::Screen(int dimx, int dimy)
     : stencil{0, dimx - 1, 0, dimy - 1},
       dimx_(dimx),
       dimy_(dimy),
-      pixels_(dimy, std::vector<Pixel>(dimx)) {
+      pixels_(dimx * dimy) {
 #if defined(_WIN32)
   // The placement of this call is a bit weird, however we can assume that
   // anybody who instantiates a Screen object eventually wants to output
@@ -365,29 +677,235 @@ Screen::Screen(int dimx, int dimy)
 /// Produce a std::string that can be used to print the Screen on the terminal.
 /// Don't forget to flush stdout. Alternatively, you can use Screen::Print();
 std::string Screen::ToString() {
-  std::stringstream ss;
+  std::string out;
+  Serialize(out);
+  return out;
+}
+
+/// Produce a std::string updating a terminal displaying |previous| into this
+/// Screen. Only the modified cells are printed, the cursor is moved over the
+/// others.
+///
+/// Like for the output of Screen::ToString(), the cursor is expected to be at
+/// the top-left corner of the Screen and is left on its bottom-right corner.
+/// Both screens must have the same dimensions.
+std::string Screen::ToString(const Screen& previous) {
+  std::string out;
+  Serialize(previous, out);
+  return out;
+}
 
-  Pixel previous_pixel;
-  Pixel final_pixel;
+/// Append the output of Screen::ToString() to |out|.
+///
+/// Nothing is allocated when |out| has enough capacity, so reusing the same
+/// buffer for every frame avoids allocating memory.
+void Screen::Serialize(std::string& out) {
+  PixelWriter writer(out, output_mode_);
+  const bool bulk =
+      !output_mode_.compress && !output_mode_.dec_special_graphics;
 
   for (int y = 0; y < dimy_; ++y) {
     if (y != 0) {
-      UpdatePixelStyle(ss, previous_pixel, final_pixel);
-      ss << "\r\n";
+      writer.Flush(/*end_of_row=*/true);
+      writer.ResetStyle();
+      out += "\r\n";
+    }
+    const Pixel* it = Row(y);
+    const Pixel* const end = it + dimx_;
+    while (it != end) {
+      // Copy in bulk the run of ASCII characters sharing the same style.
+      if (bulk) {
+        const Pixel* run_end = it;
+        while (run_end != end && IsAscii(run_end->character) &&
+               SameStyle(*run_end, *it)) {
+          ++run_end;
+        }
+        if (run_end != it) {
+          writer.PrintAscii(it, run_end);
+          it = run_end;
+          continue;
+        }
+      }
+
+      writer.Print(*it);
+      // The right half of a fullwidth character is never printed.
+      if (it->character.width() == 2 && it + 1 != end)
+        ++it;
+      ++it;
     }
+  }
+
+  // The cursor is expected to be left at the end of the last row.
+  writer.Flush(/*end_of_row=*/false);
+  writer.Reset();
+}
+
+/// Append the output of Screen::ToString(previous) to |out|.
+///
+/// Nothing is allocated when |out| has enough capacity.
+void Screen::Serialize(const Screen& previous, std::string& out) {
+  PixelWriter writer(out, output_mode_);
+
+  int cursor_x = 0;
+  int cursor_y = 0;
+
+  // The cursor is left before the cells erased at the end of the row.
+  auto flush = [&] { cursor_x -= writer.Flush(cursor_x == dimx_); };
+
+  for (int y = 0; y < dimy_; ++y) {
+    const Pixel* line = Row(y);
+    const Pixel* previous_line = previous.pixels_.data() + y * dimx_;
+
+    auto print = [&](int x) {
+      writer.Print(line[x]);
+      const int width = line[x].character.width();
+      cursor_x = (width == 1 || width == 2) ? x + width : -1;
+    };
+
+    bool fullwidth = false;
     bool previous_fullwidth = false;
-    for (const auto& pixel : pixels_[y]) {
-      if (!previous_fullwidth) {
-        UpdatePixelStyle(ss, previous_pixel, pixel);
-        ss << pixel.character;
+    for (int x = 0; x < dimx_; ++x) {
+      const bool covered = fullwidth;
+      const bool previously_covered = previous_fullwidth;
+      fullwidth = (line[x].character.width() == 2);
+      previous_fullwidth = (previous_line[x].character.width() == 2);
+
+      // The right half of a fullwidth character is never printed.
+      if (covered)
+        continue;
+
+      if (!previously_covered && SamePixel(line[x], previous_line[x]))
+        continue;
+
+      if (cursor_y == y && cursor_x >= 0 && x > cursor_x &&
+          x - cursor_x <= kMaxReprintedCells) {
+        while (cursor_x >= 0 && cursor_x < x)
+          print(cursor_x);
+      }
+
+      if (x != cursor_x || y != cursor_y) {
+        flush();
+        MoveCursor(out, cursor_x, cursor_y, x, y);
       }
-      previous_fullwidth = (string_width(pixel.character) == 2);
+      print(x);
     }
   }
 
-  UpdatePixelStyle(ss, previous_pixel, final_pixel);
+  flush();
+  writer.Reset();
 
-  return ss.str();
+  if (dimx_ != 0 && dimy_ != 0)
+    MoveCursor(out, cursor_x, cursor_y, dimx_ - 1, dimy_ - 1);
+}
+
+/// Scroll the terminal, when this Screen contains rows of |previous| shifted
+/// vertically, like a log view receiving new lines. The terminal moves the
+/// shifted rows itself, instead of having them reprinted.
+///
+/// The scrolling sequences are appended to |out| and |previous| is updated to
+/// match the content of the terminal after scrolling. Use
+/// Serialize(previous, out) afterward to print the remaining differences.
+///
+/// Only the region saving the most rows is scrolled. Terminals scroll whole
+/// rows, so the Screen must be drawn at the top-left corner of the terminal and
+/// span its width. The current style must be the default one. The cursor is
+/// left at the top-left corner.
+void Screen::SerializeScroll(Screen& previous, std::string& out) {
+  if (previous.dimx_ != dimx_ || previous.dimy_ != dimy_)
+    return;
+
+  // The hashes of |previous| were computed when it was the current frame.
+  row_hashes_.resize(dimy_);
+  for (int y = 0; y < dimy_; ++y)
+    row_hashes_[y] = HashRow(Row(y), dimx_);
+  if (previous.row_hashes_.size() != size_t(dimy_)) {
+    previous.row_hashes_.resize(dimy_);
+    for (int y = 0; y < dimy_; ++y)
+      previous.row_hashes_[y] = HashRow(previous.Row(y), dimx_);
+  }
+  const std::vector<uint64_t>& current = row_hashes_;
+  std::vector<uint64_t>& old = previous.row_hashes_;
+
+  // Find the |shift| and the rows [begin, end) of this Screen equal to the
+  // rows [begin + shift, end + shift) of |previous|, maximizing the number of
+  // modified rows they contain.
+  int best_shift = 0;
+  int best_begin = 0;
+  int best_end = 0;
+  int best_saved = 0;
+  for (int shift = 1 - dimy_; shift < dimy_; ++shift) {
+    if (shift == 0)
+      continue;
+    const int first = std::max(0, -shift);
+    const int last = std::min(dimy_, dimy_ - shift);
+    int begin = first;
+    int saved = 0;
+    for (int y = first; y <= last; ++y) {
+      if (y != last && current[y] == old[y + shift]) {
+        saved += (current[y] != old[y]);
+        continue;
+      }
+      if (saved > best_saved) {
+        best_shift = shift;
+        best_begin = begin;
+        best_end = y;
+        best_saved = saved;
+      }
+      begin = y + 1;
+      saved = 0;
+    }
+  }
+
+  if (best_saved < kMinScrolledRows)
+    return;
+
+  // The rows [top, bottom] are scrolled. The |exposed| ones are left blank.
+  const int distance = std::abs(best_shift);
+  const int top = best_shift > 0 ? best_begin : best_begin - distance;
+  const int bottom = best_shift > 0 ? best_end + distance - 1 : best_end - 1;
+  const int exposed = best_shift > 0 ? best_end : top;
+
+  // The exposed rows might have been left unmodified otherwise.
+  const uint64_t blank = HashBlankRow(dimx_);
+  for (int y = exposed; y < exposed + distance; ++y) {
+    if (current[y] == old[y] && current[y] != blank)
+      --best_saved;
+  }
+  if (best_saved < kMinScrolledRows)
+    return;
+
+  // Guard against hash collisions.
+  for (int y = best_begin; y < best_end; ++y) {
+    if (!SameRow(Row(y), previous.Row(y + best_shift), dimx_))
+      return;
+  }
+
+  // DECSTBM: Set the scrolling region. This moves the cursor home.
+  out += "\x1B[";
+  AppendNumber(out, top + 1);
+  out += ';';
+  AppendNumber(out, bottom + 1);
+  out += 'r';
+  // SU or SD: Scroll up or down.
+  out += "\x1B[";
+  AppendNumber(out, distance);
+  out += best_shift > 0 ? 'S' : 'T';
+  // DECSTBM: Reset the scrolling region.
+  out += "\x1B[r";
+
+  if (best_shift > 0) {
+    std::copy(previous.Row(top + distance), previous.Row(bottom + 1),
+              previous.Row(top));
+    std::copy(old.begin() + top + distance, old.begin() + bottom + 1,
+              old.begin() + top);
+  } else {
+    std::copy_backward(previous.Row(top), previous.Row(bottom + 1 - distance),
+                       previous.Row(bottom + 1));
+    std::copy_backward(old.begin() + top, old.begin() + bottom + 1 - distance,
+                       old.begin() + bottom + 1);
+  }
+  std::fill(previous.Row(exposed), previous.Row(exposed + distance), Pixel());
+  std::fill(old.begin() + exposed, old.begin() + exposed + distance, blank);
 }
 
 void Screen::Print() {
@@ -397,7 +915,7 @@ void Screen::Print() {
 /// @brief Access a character a given position.
 /// @param x The character position along the x-axis.
 /// @param y The character position along the y-axis.
-std::string& Screen::at(int x, int y) {
+Glyph& Screen::at(int x, int y) {
   return PixelAt(x, y).character;
 }
 
@@ -405,7 +923,7 @@ std::string& Screen::at(int x, int y) {
 /// @param x The pixel position along the x-axis.
 /// @param y The pixel position along the y-axis.
 Pixel& Screen::PixelAt(int x, int y) {
-  return stencil.Contain(x, y) ? pixels_[y][x] : dev_null_pixel;
+  return stencil.Contain(x, y) ? pixels_[y * dimx_ + x] : dev_null_pixel;
 }
 
 /// @brief Return a string to be printed in order to reset the cursor position
@@ -428,25 +946,33 @@ Pixel& Screen::PixelAt(int x, int y) {
 /// @return The string to print in order to reset the cursor position to the
 ///         beginning.
 std::string Screen::ResetPosition(bool clear) {
-  std::stringstream ss;
+  std::string out;
+  ResetPosition(out, clear);
+  return out;
+}
+
+/// @brief Append the output of Screen::ResetPosition(clear) to |out|.
+void Screen::ResetPosition(std::string& out, bool clear) {
   if (clear) {
-    ss << MOVE_LEFT << CLEAR_LINE;
+    out += MOVE_LEFT;
+    out += CLEAR_LINE;
     for (int y = 1; y < dimy_; ++y) {
-      ss << MOVE_UP << CLEAR_LINE;
+      out += MOVE_UP;
+      out += CLEAR_LINE;
     }
   } else {
-    ss << MOVE_LEFT;
+    out += MOVE_LEFT;
     for (int y = 1; y < dimy_; ++y) {
-      ss << MOVE_UP;
+      out += MOVE_UP;
     }
   }
-  return ss.str();
 }
 
 /// @brief Clear all the pixel from the screen.
+/// The storage is reused, this doesn't allocate memory.
 void Screen::Clear() {
-  pixels_ = std::vector<std::vector<Pixel>>(dimy_,
-                                            std::vector<Pixel>(dimx_, Pixel()));
+  std::fill(pixels_.begin(), pixels_.end(), Pixel());
+  row_hashes_.clear();
   cursor_.x = dimx_ - 1;
   cursor_.y = dimy_ - 1;
 }
@@ -455,20 +981,21 @@ void Screen::Clear() {
 void Screen::ApplyShader() {
   // Merge box characters togethers.
   for (int y = 1; y < dimy_; ++y) {
+    Pixel* line = Row(y);
+    Pixel* previous_line = Row(y - 1);
     for (int x = 1; x < dimx_; ++x) {
-      // Box drawing character uses exactly 3 byte.
-      std::string& cur = pixels_[y][x].character;
-      if (cur.size() != 3u)
+      Glyph& cur = line[x].character;
+      if (!IsBoxDrawing(cur))
         continue;
 
       // Left vs current.
-      std::string& left = pixels_[y][x-1].character;
-      if (left.size() == 3u)
+      Glyph& left = line[x-1].character;
+      if (IsBoxDrawing(left))
         UpgradeLeftRight(left, cur);
 
       // Top vs current.
-      std::string& top = pixels_[y-1][x].character;
-      if (top.size() == 3u)
+      Glyph& top = previous_line[x].character;
+      if (IsBoxDrawing(top))
         UpgradeTopDown(top, cur);
     }
   }
@@ -0,0 +1,313 @@
+#include <gtest/gtest-message.h>  // for Message
+#include <gtest/gtest-test-part.h>  // for TestPartResult, SuiteApiResolver, TestFactoryImpl
+#include <string>                   // for allocator, string
+
+#include "ftxui/screen/color.hpp"   // for Color, Color::Red
+#include "ftxui/screen/screen.hpp"  // for Screen
+#include "gtest/gtest_pred_impl.h"  // for EXPECT_EQ, Test, TEST
+
+using namespace ftxui;
+
+namespace {
+void Write(Screen& screen, int y, const std::string& line) {
+  for (size_t x = 0; x < line.size(); ++x)
+    screen.at(x, y) = std::string(1, line[x]);
+}
+}  // namespace
+
+TEST(ScreenTest, DiffIdentical) {
+  Screen previous(3, 2);
+  Screen screen(3, 2);
+
+  // Only move the cursor to the bottom-right corner.
+  EXPECT_EQ("\x1B[1B\x1B[3G", screen.ToString(previous));
+}
+
+TEST(ScreenTest, DiffOneCell) {
+  Screen previous(10, 1);
+  Screen screen(10, 1);
+  Write(previous, 0, "abcdefghij");
+  Write(screen, 0, "abcdefGhij");
+
+  EXPECT_EQ("\x1B[7GG\x1B[10G", screen.ToString(previous));
+}
+
+TEST(ScreenTest, DiffReprintShortGap) {
+  Screen previous(10, 1);
+  Screen screen(10, 1);
+  Write(previous, 0, "abcdefghij");
+  Write(screen, 0, "Abcdefghij");
+  screen.at(3, 0) = "D";
+
+  EXPECT_EQ("AbcD\x1B[10G", screen.ToString(previous));
+}
+
+TEST(ScreenTest, DiffSeveralLines) {
+  Screen previous(3, 3);
+  Screen screen(3, 3);
+  screen.at(1, 0) = "a";
+  screen.at(2, 2) = "b";
+
+  // The cursor is already on the right column when moving down.
+  EXPECT_EQ(" a\x1B[2Bb\x1B[3G", screen.ToString(previous));
+}
+
+TEST(ScreenTest, DiffStyle) {
+  Screen previous(3, 1);
+  Screen screen(3, 1);
+  screen.PixelAt(1, 0).foreground_color = Color::Red;
+
+  EXPECT_EQ(" \x1B[31m \x1B[39m",
+            screen.ToString(previous));
+}
+
+TEST(ScreenTest, DiffFullwidth) {
+  Screen previous(10, 1);
+  Screen screen(10, 1);
+  Write(previous, 0, "abcdefghij");
+  Write(screen, 0, "abcdefghij");
+  screen.at(6, 0) = "测";
+  screen.at(7, 0) = "";
+
+  // The right half of the fullwidth character isn't printed.
+  EXPECT_EQ("\x1B[7G测\x1B[10G", screen.ToString(previous));
+
+  // Going back, the cell uncovered by the fullwidth character is printed.
+  EXPECT_EQ("\x1B[7Ggh\x1B[10G", previous.ToString(screen));
+}
+
+TEST(ScreenTest, Row) {
+  Screen screen(3, 2);
+  screen.at(1, 1) = "a";
+  EXPECT_EQ(screen.Row(1)[1].character, "a");
+  EXPECT_EQ(screen.Row(0) + 3, screen.Row(1));
+}
+
+TEST(ScreenTest, ClearReuseStorage) {
+  Screen screen(3, 2);
+  screen.at(1, 1) = "a";
+  Pixel* storage = screen.Row(0);
+  screen.Clear();
+  EXPECT_EQ(storage, screen.Row(0));
+  EXPECT_EQ(screen.at(1, 1), " ");
+}
+
+TEST(ScreenTest, StyleCombined) {
+  Screen screen(2, 1);
+  screen.PixelAt(0, 0).bold = true;
+  screen.PixelAt(0, 0).underlined = true;
+  screen.PixelAt(0, 0).foreground_color = Color::RGB(255, 0, 10);
+  screen.PixelAt(0, 0).background_color = Color::Palette256(123);
+  screen.PixelAt(1, 0).bold = true;
+  screen.PixelAt(1, 0).background_color = Color::Palette256(123);
+
+  // Forced to stay independent of the terminal color support.
+  const std::string rgb = Color::RGB(255, 0, 10).Print(false);
+  const std::string palette = Color(Color::Palette256(123)).Print(true);
+
+  EXPECT_EQ("\x1B[1;4;" + rgb + ";" + palette + "m \x1B[24;39m \x1B[22;49m",
+            screen.ToString());
+}
+
+TEST(ScreenTest, StyleBoldAndDim) {
+  Screen screen(3, 1);
+  screen.PixelAt(0, 0).bold = true;
+  screen.PixelAt(0, 0).dim = true;
+  screen.PixelAt(1, 0).dim = true;
+
+  // Bold and dim are reset together.
+  EXPECT_EQ("\x1B[1;2m \x1B[22;2m \x1B[22m ", screen.ToString());
+}
+
+TEST(ScreenTest, SerializeAppends) {
+  Screen screen(6, 2);
+  screen.at(0, 0) = "a";
+  screen.at(1, 0) = "b";
+  screen.PixelAt(2, 0).bold = true;
+  screen.at(2, 0) = "c";
+  screen.PixelAt(3, 0).bold = true;
+  screen.at(3, 0) = "d";
+  screen.at(4, 0) = "测";
+  screen.at(0, 1) = "é";
+
+  std::string out = "previous";
+  screen.Serialize(out);
+  EXPECT_EQ("previousab\x1B[1mcd\x1B[22m测\r\né     ", out);
+  EXPECT_EQ(out.substr(8), screen.ToString());
+}
+
+TEST(ScreenTest, SerializeReuseBuffer) {
+  Screen previous(3, 1);
+  Screen screen(3, 1);
+  screen.at(2, 0) = "a";
+
+  // The cells before "a" are reprinted, this is shorter than moving.
+  std::string out;
+  screen.Serialize(previous, out);
+  EXPECT_EQ("  a\x1B[3G", out);
+
+  // A frame too long to be stored inline in the string. The buffer allocated
+  // for it is reused by the next frames.
+  Screen blank(64, 4);
+  Screen large(64, 4);
+  for (int y = 0; y < 4; ++y) {
+    for (int x = 0; x < 64; ++x)
+      large.at(x, y) = "x";
+  }
+  out.clear();
+  large.Serialize(blank, out);
+  const std::string expected = out;
+  ASSERT_GT(expected.size(), 200u);
+  const char* data = out.data();
+  const size_t capacity = out.capacity();
+
+  for (int i = 0; i < 3; ++i) {
+    out.clear();
+    large.Serialize(blank, out);
+    EXPECT_EQ(expected, out);
+    EXPECT_EQ(data, out.data());
+    EXPECT_EQ(capacity, out.capacity());
+  }
+}
+
+TEST(ScreenTest, ShaderMergeBoxDrawing) {
+  Screen screen(3, 3);
+  screen.at(0, 0) = "─";
+  screen.at(1, 0) = "│";
+  screen.at(0, 1) = "━";
+  screen.at(1, 1) = "┃";
+  screen.at(2, 1) = "═";
+  screen.at(1, 2) = "║";
+  screen.at(2, 2) = "x";
+  screen.ApplyShader();
+
+  auto row = [&](int y) {
+    std::string out;
+    for (int x = 0; x < screen.dimx(); ++x)
+      out += screen.at(x, y);
+    return out;
+  };
+  EXPECT_EQ("─│ ", row(0));
+  EXPECT_EQ("━┫═", row(1));
+  EXPECT_EQ(" ║x", row(2));
+}
+
+namespace {
+Screen Lines(std::vector<std::string> lines) {
+  Screen screen(3, lines.size());
+  for (int y = 0; y < (int)lines.size(); ++y) {
+    for (int x = 0; x < (int)lines[y].size(); ++x)
+      screen.at(x, y) = std::string(1, lines[y][x]);
+  }
+  return screen;
+}
+}  // namespace
+
+TEST(ScreenTest, ScrollUp) {
+  Screen previous = Lines({"|||", "aaa", "bbb", "ccc", "ddd", "|||"});
+  Screen screen = Lines({"|||", "bbb", "ccc", "ddd", "eee", "|||"});
+
+  std::string out;
+  screen.SerializeScroll(previous, out);
+  EXPECT_EQ("\x1B[2;5r\x1B[1S\x1B[r", out);
+  EXPECT_EQ(Lines({"|||", "bbb", "ccc", "ddd", "   ", "|||"}).ToString(),
+            previous.ToString());
+
+  out.clear();
+  screen.Serialize(previous, out);
+  EXPECT_EQ("\x1B[4Beee\x1B[1B\x1B[3G", out);
+}
+
+TEST(ScreenTest, ScrollDown) {
+  Screen previous = Lines({"aaa", "bbb", "ccc", "ddd"});
+  Screen screen = Lines({"xxx", "yyy", "aaa", "bbb"});
+
+  std::string out;
+  screen.SerializeScroll(previous, out);
+  EXPECT_EQ("\x1B[1;4r\x1B[2T\x1B[r", out);
+  EXPECT_EQ(Lines({"   ", "   ", "aaa", "bbb"}).ToString(),
+            previous.ToString());
+}
+
+TEST(ScreenTest, ScrollTwice) {
+  Screen previous = Lines({"|||", "aaa", "bbb", "ccc", "ddd", "|||"});
+  Screen screen = Lines({"|||", "bbb", "ccc", "ddd", "eee", "|||"});
+  Screen next = Lines({"|||", "ccc", "ddd", "eee", "fff", "|||"});
+
+  std::string out;
+  screen.SerializeScroll(previous, out);
+  EXPECT_EQ("\x1B[2;5r\x1B[1S\x1B[r", out);
+
+  // The row hashes of |screen| are reused and shifted along with its rows.
+  out.clear();
+  next.SerializeScroll(screen, out);
+  EXPECT_EQ("\x1B[2;5r\x1B[1S\x1B[r", out);
+  EXPECT_EQ(Lines({"|||", "ccc", "ddd", "eee", "   ", "|||"}).ToString(),
+            screen.ToString());
+
+  out.clear();
+  Lines({"|||", "ddd", "eee", "   ", "ggg", "|||"}).SerializeScroll(screen, out);
+  EXPECT_EQ("\x1B[2;5r\x1B[1S\x1B[r", out);
+  EXPECT_EQ(Lines({"|||", "ddd", "eee", "   ", "   ", "|||"}).ToString(),
+            screen.ToString());
+}
+
+TEST(ScreenTest, ScrollNotWorthIt) {
+  // Scrolling would save reprinting the first "bbb", but would erase the
+  // second one.
+  Screen previous = Lines({"aaa", "bbb", "ccc"});
+  Screen screen = Lines({"bbb", "bbb", "ccc"});
+
+  std::string out;
+  screen.SerializeScroll(previous, out);
+  EXPECT_EQ("", out);
+
+  // Nothing is shifted.
+  screen.SerializeScroll(screen, out);
+  EXPECT_EQ("", out);
+}
+
+TEST(ScreenTest, CompressRepeat) {
+  Screen screen(12, 2);
+  screen.SetOutputMode({/*compress=*/true, /*dec_special_graphics=*/false});
+  for (int x = 0; x < 10; ++x)
+    screen.at(x, 0) = "─";
+  screen.at(0, 1) = "a";
+  screen.at(1, 1) = "a";
+
+  // The two spaces ending the first row are too few to be worth erasing. The
+  // spaces ending the last row are never erased, the cursor must end on the
+  // last cell.
+  EXPECT_EQ("─\x1B[9b  \r\naa \x1B[9b", screen.ToString());
+}
+
+TEST(ScreenTest, CompressErase) {
+  Screen previous(10, 2);
+  Screen screen(10, 2);
+  screen.SetOutputMode({/*compress=*/true, /*dec_special_graphics=*/false});
+  for (int x = 0; x < 10; ++x) {
+    previous.at(x, 0) = "a";
+    previous.at(x, 1) = "b";
+  }
+  for (int x = 0; x < 10; ++x)
+    screen.at(x, 1) = "b";
+  screen.at(0, 0) = "a";
+
+  // The cell before the erased ones is reprinted, this is shorter than moving.
+  EXPECT_EQ("a\x1B[9X\x1B[1B\x1B[10G", screen.ToString(previous));
+}
+
+TEST(ScreenTest, DecSpecialGraphics) {
+  Screen screen(4, 1);
+  screen.SetOutputMode({/*compress=*/false, /*dec_special_graphics=*/true});
+  screen.at(0, 0) = "┌";
+  screen.at(1, 0) = "─";
+  screen.at(2, 0) = "q";
+  screen.at(3, 0) = "━";
+
+  EXPECT_EQ("\x1B(0lq\x1B(Bq━", screen.ToString());
+}
+
+// Copyright 2021 Arthur Sonzogni. All rights reserved.
+// Use of this source code is governed by the MIT license that can be found in
+// the LICENSE file.